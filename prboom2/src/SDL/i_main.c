@@ -75,7 +75,9 @@
 #include "dsda/args.h"
 #include "dsda/analysis.h"
 #include "dsda/args.h"
+#include "dsda/brute_force.h"
 #include "dsda/endoom.h"
+#include "dsda/playback.h"
 #include "dsda/settings.h"
 #include "dsda/signal_context.h"
 #include "dsda/split_tracker.h"
@@ -177,6 +179,11 @@ void I_SafeExit(int rc)
 {
   atexit_listentry_t *entry;
 
+  // -playdemolist workers leave through dsda_AdvancePlaybackList,
+  //   and brute force workers report over their pipe
+  dsda_AbortPlaybackWorker(NULL);
+  dsda_AbortBFWorker();
+
   lprintf(LO_DEBUG, "\n"); // Separator after game loop
 
   // Run through all exit functions
@@ -273,6 +280,14 @@ int main(int argc, char **argv)
   if (dsda_Flag(dsda_arg_quiet))
     I_DisableAllLogging();
 
+  // Start early so the long-lived startup allocations are attributed too
+  {
+    dsda_arg_t* arg = dsda_Arg(dsda_arg_zone_stats);
+
+    if (arg->found)
+      Z_EnableSiteStats(arg->value.v_string);
+  }
+
   // Print the version and exit
   if (dsda_Flag(dsda_arg_v))
   {
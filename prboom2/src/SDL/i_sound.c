@@ -71,6 +71,7 @@
 #include "e6y.h"
 
 #include "dsda/settings.h"
+#include "dsda/trace.h"
 
 static dboolean registered_non_rw = false;
 
@@ -569,6 +570,8 @@ static void I_UpdateSound(void *unused, Uint8 *stream, int len)
   if (dumping_sound && unused != (void *) 0xdeadbeef)
     return;
 
+  DSDA_TRACE_BEGIN("update_sound");
+
   // do music update
   if (registered_non_rw)
   {
@@ -689,6 +692,8 @@ static void I_UpdateSound(void *unused, Uint8 *stream, int len)
     rightout += step;
   }
   SDL_UnlockMutex (sfxmutex);
+
+  DSDA_TRACE_END("update_sound");
 }
 
 static dboolean sound_was_initialized;
@@ -84,11 +84,13 @@
 #include "i_main.h"
 
 #include "dsda/args.h"
+#include "dsda/benchmark.h"
 #include "dsda/configuration.h"
 #include "dsda/game_controller.h"
 #include "dsda/palette.h"
 #include "dsda/pause.h"
 #include "dsda/settings.h"
+#include "dsda/signal_context.h"
 #include "dsda/time.h"
 #include "dsda/gl/render_scale.h"
 
@@ -580,7 +582,7 @@ void I_HandleCapture(void)
 static int newpal = 0;
 #define NO_PALETTE_CHANGE 1000
 
-void I_FinishUpdate (void)
+static void I_FinishUpdateInternal (void)
 {
   //e6y: new mouse code
   UpdateGrab();
@@ -645,6 +647,15 @@ void I_FinishUpdate (void)
   SDL_RenderPresent(sdl_renderer);
 }
 
+void I_FinishUpdate (void)
+{
+  DSDA_ADD_CONTEXT(sf_finish_update);
+  DSDA_BENCHMARK_BEGIN(dsda_bench_blit);
+  I_FinishUpdateInternal();
+  DSDA_BENCHMARK_END(dsda_bench_blit);
+  DSDA_REMOVE_CONTEXT(sf_finish_update);
+}
+
 //
 // I_ScreenShot - moved to i_sshot.c
 //
@@ -1225,7 +1236,8 @@ void I_UpdateVideoMode(void)
   int integer_scaling;
   const char *sdl_video_window_pos;
   const dboolean novsync = dsda_Flag(dsda_arg_timedemo) ||
-                           dsda_Flag(dsda_arg_fastdemo);
+                           dsda_Flag(dsda_arg_fastdemo) ||
+                           dsda_Flag(dsda_arg_playdemolist);
 
   exclusive_fullscreen = dsda_IntConfig(dsda_config_exclusive_fullscreen) &&
                          I_DesiredVideoMode() == VID_MODESW;
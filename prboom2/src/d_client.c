@@ -63,6 +63,7 @@
 #include "dsda/args.h"
 #include "dsda/settings.h"
 #include "dsda/time.h"
+#include "dsda/trace.h"
 
 ticcmd_t local_cmds[MAX_MAXPLAYERS][BACKUPTICS];
 int maketic;
@@ -145,7 +146,9 @@ void TryRunTics (void)
     if (advancedemo)
       D_DoAdvanceDemo ();
     M_Ticker ();
+    DSDA_TRACE_BEGIN("tic");
     G_Ticker ();
+    DSDA_TRACE_END("tic");
     gametic++;
     FakeNetUpdate();
   }
@@ -1533,6 +1533,17 @@ static const deh_bexptr deh_bexptrs[] = // CPhipps - static const
   {NULL,              "A_NULL"},  // Ty 05/16/98
 };
 
+const char* deh_ActionName(actionf_t cptr)
+{
+  int i;
+
+  for (i = 0; deh_bexptrs[i].cptr != NULL; i++)
+    if (deh_bexptrs[i].cptr == cptr)
+      return deh_bexptrs[i].lookup;
+
+  return NULL;
+}
+
 int deh_maxhealth;
 int deh_max_soul;
 int deh_mega_health;
@@ -43,6 +43,7 @@
 #define __D_DEH__
 
 #include "doomtype.h"
+#include "d_think.h"
 
 void ProcessDehFile(const char *filename, const char *outfilename, int lumpnum);
 void PostProcessDeh(void);
@@ -1067,5 +1068,6 @@ uint64_t deh_stringToMBF21MobjFlags(char *strval);
 uint64_t deh_stringToMobjFlags(char *strval);
 void deh_changeCompTranslucency(void);
 void deh_applyCompatibility(void);
+const char* deh_ActionName(actionf_t cptr);
 
 #endif
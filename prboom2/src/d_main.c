@@ -84,10 +84,12 @@
 #include "e6y.h"
 
 #include "dsda/args.h"
+#include "dsda/benchmark.h"
 #include "dsda/configuration.h"
 #include "dsda/demo.h"
 #include "dsda/exdemo.h"
 #include "dsda/features.h"
+#include "dsda/frame_stats.h"
 #include "dsda/global.h"
 #include "dsda/save.h"
 #include "dsda/data_organizer.h"
@@ -104,7 +106,9 @@
 #include "dsda/skill_info.h"
 #include "dsda/skip.h"
 #include "dsda/sndinfo.h"
+#include "dsda/state_hash.h"
 #include "dsda/time.h"
+#include "dsda/trace.h"
 #include "dsda/utility.h"
 #include "dsda/wad_stats.h"
 #include "dsda/zipfile.h"
@@ -522,6 +526,9 @@ void D_Display (fixed_t frac)
   dsda_LimitFPS();
 
   I_EndDisplay();
+
+  dsda_UpdateBenchmark();
+  dsda_UpdateFrameStats();
 }
 
 //
@@ -557,7 +564,9 @@ static void D_DoomLoop(void)
       if (advancedemo)
         D_DoAdvanceDemo ();
       M_Ticker ();
+      DSDA_TRACE_BEGIN("tic");
       G_Ticker ();
+      DSDA_TRACE_END("tic");
       gametic++;
       maketic++;
     }
@@ -1660,6 +1669,16 @@ static void D_DoomMainSetup(void)
     I_SafeExit(0);
   }
 
+  arg = dsda_Arg(dsda_arg_compare_state_hash);
+  if (arg->found)
+  {
+    int result;
+
+    result = dsda_CompareStateHashFiles(arg->value.v_string_array[0],
+                                        arg->value.v_string_array[1]);
+    I_SafeExit(result);
+  }
+
   DoLooseFiles();  // Ty 08/29/98 - handle "loose" files on command line
 
   IdentifyVersion();
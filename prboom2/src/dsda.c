@@ -33,11 +33,14 @@
 #include "dsda/demo.h"
 #include "dsda/exhud.h"
 #include "dsda/features.h"
+#include "dsda/frame_stats.h"
 #include "dsda/ghost.h"
 #include "dsda/key_frame.h"
 #include "dsda/mouse.h"
 #include "dsda/settings.h"
 #include "dsda/split_tracker.h"
+#include "dsda/state_hash.h"
+#include "dsda/trace.h"
 #include "dsda/tracker.h"
 #include "dsda/wad_stats.h"
 #include "dsda.h"
@@ -178,6 +181,18 @@ void dsda_ReadCommandLine(void) {
   if (arg->found)
     dsda_InitGhostImport(arg->value.v_string_array, arg->count);
 
+  arg = dsda_Arg(dsda_arg_export_state_hash);
+  if (arg->found)
+    dsda_InitStateHashExport(arg->value.v_string, dsda_Flag(dsda_arg_state_hash_archive));
+
+  arg = dsda_Arg(dsda_arg_trace);
+  if (arg->found)
+    dsda_InitTrace(arg->value.v_string);
+
+  arg = dsda_Arg(dsda_arg_log_frame_times);
+  if (arg->found)
+    dsda_InitFrameTimeLog(arg->value.v_string);
+
   if (dsda_Flag(dsda_arg_tas) || dsda_Flag(dsda_arg_build)) dsda_SetTas();
 
   dsda_InitKeyFrame();
@@ -385,6 +400,7 @@ int dsda_MaxKillRequirement() {
 
 void dsda_WatchPTickCompleted(void) {
   dsda_FlipLineActivationTracker();
+  dsda_UpdateStateHashExport();
 }
 
 void dsda_WatchCommand(void) {
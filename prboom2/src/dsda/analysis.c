@@ -72,20 +72,10 @@ void dsda_ResetAnalysis(void) {
   dsda_weapon_collector = true;
 }
 
-void dsda_WriteAnalysis(void) {
-  FILE *fstream = NULL;
+void dsda_WriteAnalysisToStream(FILE* fstream) {
   const char* category = NULL;
   int is_signed;
 
-  if (!dsda_analysis) return;
-
-  fstream = M_OpenFile("analysis.txt", "w");
-
-  if (fstream == NULL) {
-    fprintf(stderr, "Unable to open analysis.txt for writing!\n");
-    return;
-  }
-
   category = dsda_DetectCategory();
   is_signed = dsda_IsExDemoSigned();
 
@@ -109,6 +99,21 @@ void dsda_WriteAnalysis(void) {
   fprintf(fstream, "coop_spawns %d\n", coop_spawns);
   fprintf(fstream, "category %s\n", category);
   fprintf(fstream, "signature %d\n", is_signed);
+}
+
+void dsda_WriteAnalysis(void) {
+  FILE *fstream = NULL;
+
+  if (!dsda_analysis) return;
+
+  fstream = M_OpenFile("analysis.txt", "w");
+
+  if (fstream == NULL) {
+    fprintf(stderr, "Unable to open analysis.txt for writing!\n");
+    return;
+  }
+
+  dsda_WriteAnalysisToStream(fstream);
 
   fclose(fstream);
 
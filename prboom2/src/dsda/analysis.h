@@ -18,6 +18,8 @@
 #ifndef __DSDA_ANALYSIS__
 #define __DSDA_ANALYSIS__
 
+#include <stdio.h>
+
 #include "doomtype.h"
 
 extern int dsda_analysis;
@@ -50,6 +52,7 @@ extern dboolean dsda_pacifist_note_shown;
 
 void dsda_ResetAnalysis(void);
 void dsda_WriteAnalysis(void);
+void dsda_WriteAnalysisToStream(FILE* fstream);
 const char* dsda_DetectCategory(void);
 
 #endif
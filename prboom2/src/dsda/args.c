@@ -93,6 +93,16 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "plays the given demo file as fast as possible, skipping some frames",
     arg_string,
   },
+  [dsda_arg_playdemolist] = {
+    "-playdemolist", NULL, NULL,
+    "plays each demo in the given list file as fast as possible, writing results to the second file",
+    arg_string_array, 0, 0, 1, 2,
+  },
+  [dsda_arg_playdemolist_jobs] = {
+    "-playdemolist_jobs", NULL, "0",
+    "splits -playdemolist across the given number of worker processes (0 = one per core)",
+    arg_int, 0, 256,
+  },
   [dsda_arg_record] = {
     "-record", NULL, NULL,
     "records a demo to the given file",
@@ -108,6 +118,36 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "restores state and demo buffer from a key frame file",
     arg_string,
   },
+  [dsda_arg_backup_auto_key_frames] = {
+    "-backup_auto_key_frames", NULL, NULL,
+    "writes every Nth auto key frame to backup-auto.kf while recording",
+    arg_int, 0, 3600,
+  },
+  [dsda_arg_seek_index] = {
+    "-seek_index", NULL, "30",
+    "caches demo key frames every N seconds (default 30) for fast seeking",
+    arg_int, 1, 3600,
+  },
+  [dsda_arg_benchmark] = {
+    "-benchmark", NULL, "benchmark.json",
+    "writes a json timing report for the played demo to the given file",
+    arg_string,
+  },
+  [dsda_arg_trace] = {
+    "-trace", NULL, NULL,
+    "records a timeline of tics, frames, and render stages to the given file (chrome trace format)",
+    arg_string,
+  },
+  [dsda_arg_log_frame_times] = {
+    "-log_frame_times", NULL, NULL,
+    "writes the duration of every frame and the tics it ran to the given csv file",
+    arg_string,
+  },
+  [dsda_arg_zone_stats] = {
+    "-zone_stats", NULL, "zone_stats.txt",
+    "records zone memory use per allocation site and writes it to the given file at exit",
+    arg_string,
+  },
   [dsda_arg_warp] = {
     "-warp", NULL, NULL,
     "warp to the given episode and / or map",
@@ -188,6 +228,16 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "turns on extended demo format (for testing)",
     arg_null,
   },
+  [dsda_arg_record_state_checksums] = {
+    "-record_state_checksums", NULL, NULL,
+    "stores a game state checksum in the demo every given number of tics",
+    arg_int, 1, 35 * 60 * 60,
+  },
+  [dsda_arg_verify_state_checksums] = {
+    "-verify_state_checksums", NULL, NULL,
+    "stops playback at the first state checksum mismatch",
+    arg_null,
+  },
   [dsda_arg_solo_net] = {
     "-solo-net", NULL, NULL,
     "play a net game with one player",
@@ -238,6 +288,11 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "quits the game when brute force ends",
     arg_null,
   },
+  [dsda_arg_brute_force_jobs] = {
+    "-brute_force_jobs", NULL, "1",
+    "splits brute force across the given number of processes (0 = one per core)",
+    arg_int, 0, 256,
+  },
   [dsda_arg_first_input] = {
     "-first_input", NULL, NULL,
     "builds the first frame F S T",
@@ -353,6 +408,21 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "imports at least one ghost file",
     arg_string_array, AT_LEAST_ONE_STRING,
   },
+  [dsda_arg_export_state_hash] = {
+    "-export_state_hash", NULL, NULL,
+    "exports a hash of the game state for every tic",
+    arg_string,
+  },
+  [dsda_arg_state_hash_archive] = {
+    "-state_hash_archive", NULL, NULL,
+    "adds a hash of the full save game state to the state hash export",
+    arg_null,
+  },
+  [dsda_arg_compare_state_hash] = {
+    "-compare_state_hash", NULL, NULL,
+    "prints the first tic where two state hash files diverge",
+    arg_string_array, EXACT_ARRAY_LENGTH(2),
+  },
   [dsda_arg_consoleplayer] = {
     "-consoleplayer", NULL, NULL,
     "sets the console player (for coop playback)",
@@ -478,6 +548,16 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "turn off drawing",
     arg_null,
   },
+  [dsda_arg_nosimd] = {
+    "-nosimd", NULL, NULL,
+    "use the scalar software drawers",
+    arg_null,
+  },
+  [dsda_arg_verify_drawers] = {
+    "-verify_drawers", NULL, NULL,
+    "check the simd drawers against the scalar ones at startup",
+    arg_null,
+  },
   [dsda_arg_nodeh] = {
     "-nodeh", NULL, NULL,
     "skip dehacked lumps inside wads",
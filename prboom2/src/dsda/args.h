@@ -29,9 +29,17 @@ typedef enum {
   dsda_arg_playlump,
   dsda_arg_timedemo,
   dsda_arg_fastdemo,
+  dsda_arg_playdemolist,
+  dsda_arg_playdemolist_jobs,
   dsda_arg_record,
   dsda_arg_recordfromto,
   dsda_arg_from_key_frame,
+  dsda_arg_backup_auto_key_frames,
+  dsda_arg_seek_index,
+  dsda_arg_benchmark,
+  dsda_arg_trace,
+  dsda_arg_log_frame_times,
+  dsda_arg_zone_stats,
   dsda_arg_warp,
   dsda_arg_skill,
   dsda_arg_uv,
@@ -48,6 +56,8 @@ typedef enum {
   dsda_arg_class,
   dsda_arg_randclass,
   dsda_arg_dsdademo,
+  dsda_arg_record_state_checksums,
+  dsda_arg_verify_state_checksums,
   dsda_arg_solo_net,
   dsda_arg_coop_spawns,
   dsda_arg_pistolstart,
@@ -58,6 +68,7 @@ typedef enum {
   dsda_arg_tas,
   dsda_arg_build,
   dsda_arg_quit_after_brute_force,
+  dsda_arg_brute_force_jobs,
   dsda_arg_first_input,
   dsda_arg_command,
   dsda_arg_skipsec,
@@ -81,6 +92,9 @@ typedef enum {
   dsda_arg_track_playback,
   dsda_arg_export_ghost,
   dsda_arg_import_ghost,
+  dsda_arg_export_state_hash,
+  dsda_arg_state_hash_archive,
+  dsda_arg_compare_state_hash,
   dsda_arg_consoleplayer,
   dsda_arg_spechit,
   dsda_arg_setmem,
@@ -106,6 +120,8 @@ typedef enum {
   dsda_arg_nomusic,
   dsda_arg_nosfx,
   dsda_arg_nodraw,
+  dsda_arg_nosimd,
+  dsda_arg_verify_drawers,
   dsda_arg_nodeh,
   dsda_arg_nomapinfo,
   dsda_arg_noautoload,
@@ -0,0 +1,235 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Benchmark
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "v_video.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/configuration.h"
+#include "dsda/time.h"
+
+#include "benchmark.h"
+
+// Sections are timed inclusively, and only the outermost call is counted
+//   when a section recurses. A "frame" is one D_Display call that draws,
+//   wherever it comes from (the main loop or the uncapped wait for tics),
+//   and its time runs from the end of the previous one. Plane and masked
+//   drawing are only separate passes in the software renderer.
+// The resolution and render_threads are recorded so that runs with one
+//   and several threads can be compared; only flats use the threads.
+
+typedef struct {
+  unsigned long long total;
+  unsigned long long start;
+  unsigned int calls;
+  int depth;
+} bench_section_t;
+
+static const char* bench_section_names[DSDA_BENCH_COUNT] = {
+  [dsda_bench_thinkers] = "thinkers",
+  [dsda_bench_sight] = "sight",
+  [dsda_bench_move] = "move",
+  [dsda_bench_bsp] = "bsp",
+  [dsda_bench_planes] = "planes",
+  [dsda_bench_masked] = "masked",
+  [dsda_bench_blit] = "blit",
+};
+
+dboolean dsda_benchmarking;
+
+static bench_section_t bench_sections[DSDA_BENCH_COUNT];
+static unsigned long long bench_start_time;
+static unsigned long long bench_frame_time;
+static int bench_start_tic;
+static unsigned int* bench_frames; // microseconds
+static int bench_frame_count;
+static int bench_frame_capacity;
+static int bench_worker = -1;
+
+void dsda_BeginBenchmarkSection(dsda_bench_section_t section) {
+  bench_section_t* s = &bench_sections[section];
+
+  if (!s->depth++)
+    s->start = dsda_TimeNS();
+}
+
+void dsda_EndBenchmarkSection(dsda_bench_section_t section) {
+  bench_section_t* s = &bench_sections[section];
+
+  if (!s->depth)
+    return;
+
+  if (!--s->depth) {
+    s->total += dsda_TimeNS() - s->start;
+    ++s->calls;
+  }
+}
+
+// Playback list workers each write their own report, "name-<worker>.ext"
+void dsda_SetBenchmarkWorker(int worker) {
+  bench_worker = worker;
+}
+
+static char* dsda_BenchmarkFileName(void) {
+  const char* name;
+  const char* ext;
+  char* result;
+  size_t length;
+
+  name = dsda_Arg(dsda_arg_benchmark)->value.v_string;
+
+  if (bench_worker < 0)
+    return Z_Strdup(name);
+
+  ext = strrchr(name, '.');
+  if (!ext || strpbrk(ext, "/\\"))
+    ext = name + strlen(name);
+
+  length = strlen(name) + 16;
+  result = Z_Malloc(length);
+  snprintf(result, length, "%.*s-%d%s", (int) (ext - name), name, bench_worker, ext);
+
+  return result;
+}
+
+void dsda_StartBenchmark(void) {
+  if (dsda_benchmarking || !demoplayback || !dsda_Flag(dsda_arg_benchmark))
+    return;
+
+  dsda_benchmarking = true;
+  bench_start_tic = gametic;
+  bench_start_time = dsda_TimeNS();
+  bench_frame_time = bench_start_time;
+}
+
+void dsda_UpdateBenchmark(void) {
+  unsigned long long now;
+
+  if (!dsda_benchmarking)
+    return;
+
+  now = dsda_TimeNS();
+
+  if (bench_frame_count == bench_frame_capacity) {
+    bench_frame_capacity = bench_frame_capacity ? bench_frame_capacity * 2 : 4096;
+    bench_frames = Z_Realloc(bench_frames, bench_frame_capacity * sizeof(*bench_frames));
+  }
+
+  bench_frames[bench_frame_count++] = (unsigned int) ((now - bench_frame_time) / 1000);
+  bench_frame_time = now;
+}
+
+static int dsda_CompareFrameTimes(const void* a, const void* b) {
+  unsigned int x = *(const unsigned int*) a;
+  unsigned int y = *(const unsigned int*) b;
+
+  return (x > y) - (x < y);
+}
+
+static double dsda_FrameTimePercentile(int percentile) {
+  int i;
+
+  if (!bench_frame_count)
+    return 0;
+
+  // Nearest rank
+  i = (bench_frame_count * percentile + 99) / 100 - 1;
+  if (i < 0)
+    i = 0;
+
+  return bench_frames[i] / 1000.0;
+}
+
+void dsda_FinishBenchmark(void) {
+  int i;
+  FILE* fstream;
+  char* name;
+  double wall_time;
+  double frame_total = 0;
+  int tics;
+
+  if (!dsda_benchmarking)
+    return;
+
+  dsda_benchmarking = false;
+
+  wall_time = (dsda_TimeNS() - bench_start_time) / 1000000000.0;
+  tics = gametic - bench_start_tic;
+
+  if (wall_time <= 0)
+    wall_time = 1e-9;
+
+  for (i = 0; i < bench_frame_count; ++i)
+    frame_total += bench_frames[i];
+
+  qsort(bench_frames, bench_frame_count, sizeof(*bench_frames), dsda_CompareFrameTimes);
+
+  name = dsda_BenchmarkFileName();
+  fstream = M_OpenFile(name, "w");
+
+  if (!fstream)
+    I_Error("dsda_FinishBenchmark: failed to open %s", name);
+
+  fprintf(fstream, "{\n");
+  fprintf(fstream, "  \"version\": \"%s\",\n", PACKAGE_VERSION);
+  fprintf(fstream, "  \"rendered\": %s,\n", nodrawers ? "false" : "true");
+  fprintf(fstream, "  \"resolution\": \"%dx%d\",\n", SCREENWIDTH, SCREENHEIGHT);
+  fprintf(fstream, "  \"render_threads\": %d,\n",
+          V_IsSoftwareMode() ? dsda_IntConfig(dsda_config_render_threads) : 1);
+  fprintf(fstream, "  \"wall_time_s\": %.6f,\n", wall_time);
+  fprintf(fstream, "  \"tics\": %d,\n", tics);
+  fprintf(fstream, "  \"frames\": %d,\n", bench_frame_count);
+  fprintf(fstream, "  \"tics_per_sec\": %.3f,\n", tics / wall_time);
+  fprintf(fstream, "  \"frames_per_sec\": %.3f,\n", bench_frame_count / wall_time);
+  fprintf(fstream, "  \"frame_time_ms\": {\n");
+  fprintf(fstream, "    \"mean\": %.3f,\n",
+          bench_frame_count ? frame_total / bench_frame_count / 1000 : 0.0);
+  fprintf(fstream, "    \"p50\": %.3f,\n", dsda_FrameTimePercentile(50));
+  fprintf(fstream, "    \"p90\": %.3f,\n", dsda_FrameTimePercentile(90));
+  fprintf(fstream, "    \"p99\": %.3f,\n", dsda_FrameTimePercentile(99));
+  fprintf(fstream, "    \"max\": %.3f\n", dsda_FrameTimePercentile(100));
+  fprintf(fstream, "  },\n");
+  fprintf(fstream, "  \"sections\": {\n");
+
+  for (i = 0; i < DSDA_BENCH_COUNT; ++i)
+    fprintf(fstream, "    \"%s\": { \"total_ms\": %.3f, \"calls\": %u }%s\n",
+            bench_section_names[i],
+            bench_sections[i].total / 1000000.0,
+            bench_sections[i].calls,
+            i == DSDA_BENCH_COUNT - 1 ? "" : ",");
+
+  fprintf(fstream, "  }\n");
+  fprintf(fstream, "}\n");
+
+  if (fclose(fstream))
+    I_Error("dsda_FinishBenchmark: failed to write %s", name);
+
+  lprintf(LO_INFO, "Benchmark: %d tics in %.3f s written to %s\n", tics, wall_time, name);
+
+  Z_Free(name);
+
+  Z_Free(bench_frames);
+  bench_frames = NULL;
+  bench_frame_count = bench_frame_capacity = 0;
+}
@@ -0,0 +1,46 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Benchmark
+//
+
+#ifndef __DSDA_BENCHMARK__
+#define __DSDA_BENCHMARK__
+
+#include "doomtype.h"
+
+typedef enum {
+  dsda_bench_thinkers,
+  dsda_bench_sight,
+  dsda_bench_move,
+  dsda_bench_bsp,
+  dsda_bench_planes,
+  dsda_bench_masked,
+  dsda_bench_blit,
+  DSDA_BENCH_COUNT
+} dsda_bench_section_t;
+
+extern dboolean dsda_benchmarking;
+
+#define DSDA_BENCHMARK_BEGIN(x) if (dsda_benchmarking) dsda_BeginBenchmarkSection(x)
+#define DSDA_BENCHMARK_END(x) if (dsda_benchmarking) dsda_EndBenchmarkSection(x)
+
+void dsda_BeginBenchmarkSection(dsda_bench_section_t section);
+void dsda_EndBenchmarkSection(dsda_bench_section_t section);
+void dsda_SetBenchmarkWorker(int worker);
+void dsda_StartBenchmark(void);
+void dsda_UpdateBenchmark(void);
+void dsda_FinishBenchmark(void);
+
+#endif
@@ -17,13 +17,25 @@
 
 #include <math.h>
 
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
 #include "d_player.h"
 #include "d_ticcmd.h"
 #include "doomstat.h"
+#include "g_game.h"
 #include "lprintf.h"
 #include "m_random.h"
 #include "r_state.h"
+#include "z_zone.h"
 
+#include "dsda/args.h"
 #include "dsda/build.h"
 #include "dsda/demo.h"
 #include "dsda/features.h"
@@ -76,12 +88,87 @@ static int bf_condition_count;
 static bf_condition_t bf_condition[MAX_BF_CONDITIONS];
 static long long bf_volume;
 static long long bf_volume_max;
+
+// Pruning moves bf_volume in uneven steps, so progress reports and worker
+//   polls count leaves and prunes instead
+#define BF_POLL_INTERVAL 10000
+static int bf_poll_countdown;
 static dboolean bf_mode;
 static dboolean bf_nomonsters;
 static dsda_key_frame_t nomo_key_frame;
 static bf_target_t bf_target;
 static ticcmd_t bf_result[MAX_BF_DEPTH];
 
+// Beam search keeps the best partial sequences (by target) at each depth
+//   and only expands those, so the work is linear in the depth
+#define MAX_BF_BEAM_DEPTH 350
+#define MAX_BF_BEAM_WIDTH 256
+
+typedef struct {
+  dsda_key_frame_t key_frame;
+  uint64_t hash;
+  fixed_t value;
+  ticcmd_t* cmds;
+} bf_beam_t;
+
+static int bf_beam_width;
+static bf_beam_t* bf_beam;
+static bf_beam_t* bf_beam_next;
+static int bf_beam_count;
+static int bf_beam_next_count;
+static int bf_beam_frame;
+static int bf_beam_parent;
+static long long bf_beam_candidate;
+static dboolean bf_beam_pending;
+static dsda_key_frame_t bf_beam_start;
+static dsda_key_frame_t bf_beam_scratch;
+
+// Parallel brute force splits the first frame with more than one command
+//   into slices, the parent keeps the first slice and each worker takes one
+static int bf_split_frame = -1;
+static long long bf_split_index;
+static long long bf_split_end;
+
+typedef struct {
+  int result;
+  long long volume;
+  long long pruned;
+  dboolean evaluated;
+  fixed_t best_value;
+  int best_depth;
+  ticcmd_t cmd[MAX_BF_DEPTH];
+} bf_worker_result_t;
+
+typedef struct {
+  int pid;
+  int fd;
+  dboolean done;
+  bf_worker_result_t result;
+} bf_worker_t;
+
+static bf_worker_t* bf_workers;
+static int bf_worker_count;
+static int bf_worker_fd = -1;
+static long long bf_total_volume_max;
+
+// Transposition table of (depth, state) pairs seen during the search
+// Two branches that reach the same state at the same depth have identical
+//   subtrees, so only the first one is simulated
+// The state is the hash of the archive in the frame's key frame, which
+//   covers everything the simulation and the conditions depend on
+#define BF_TRANSPOSITION_LIMIT (1 << 20)
+
+typedef struct {
+  int depth;
+  uint64_t hash;
+} bf_transposition_t;
+
+static dboolean bf_prune;
+static bf_transposition_t* bf_transpositions;
+static int bf_transposition_size;
+static int bf_transposition_count;
+static long long bf_pruned;
+
 const char* dsda_bf_attribute_names[dsda_bf_attribute_max] = {
   [dsda_bf_x] = "x",
   [dsda_bf_y] = "y",
@@ -173,7 +260,36 @@ static dboolean dsda_AdvanceBFRange(bf_range_t* range) {
   return true;
 }
 
+static long long dsda_BFFrameVolume(bf_t* bf) {
+  return (long long) (bf->forwardmove.max - bf->forwardmove.min + 1) *
+                     (bf->sidemove.max - bf->sidemove.min + 1) *
+                     (bf->angleturn.max - bf->angleturn.min + 1);
+}
+
+// Same order as dsda_AdvanceBruteForceFrame: angleturn changes fastest
+static void dsda_SetBFFrameIndex(bf_t* bf, long long index) {
+  int turns, sides;
+
+  turns = bf->angleturn.max - bf->angleturn.min + 1;
+  sides = bf->sidemove.max - bf->sidemove.min + 1;
+
+  bf->angleturn.i = bf->angleturn.min + index % turns;
+  index /= turns;
+  bf->sidemove.i = bf->sidemove.min + index % sides;
+  index /= sides;
+  bf->forwardmove.i = bf->forwardmove.min + index;
+}
+
 static dboolean dsda_AdvanceBruteForceFrame(int frame) {
+  if (frame == bf_split_frame) {
+    if (++bf_split_index >= bf_split_end)
+      return false;
+
+    dsda_SetBFFrameIndex(&brute_force[frame], bf_split_index);
+
+    return true;
+  }
+
   if (!dsda_AdvanceBFRange(&brute_force[frame].angleturn))
     if (!dsda_AdvanceBFRange(&brute_force[frame].sidemove))
       if (!dsda_AdvanceBFRange(&brute_force[frame].forwardmove))
@@ -182,10 +298,10 @@ static dboolean dsda_AdvanceBruteForceFrame(int frame) {
   return true;
 }
 
-static int dsda_AdvanceBruteForce(void) {
+static int dsda_AdvanceBruteForce(int frame) {
   int i;
 
-  for (i = bf_depth - 1; i >= 0; --i)
+  for (i = frame; i >= 0; --i)
     if (dsda_AdvanceBruteForceFrame(i))
       break;
 
@@ -201,6 +317,18 @@ static void dsda_CopyBFCommandDepth(ticcmd_t* cmd, bf_t* bf) {
   cmd->buttons = bf->buttons;
 }
 
+static bf_t* dsda_BeamFrame(int frame) {
+  return &brute_force[frame < MAX_BF_DEPTH ? frame : MAX_BF_DEPTH - 1];
+}
+
+static void dsda_CopyBeamCommand(ticcmd_t* cmd) {
+  bf_t bf;
+
+  bf = *dsda_BeamFrame(bf_beam_frame);
+  dsda_SetBFFrameIndex(&bf, bf_beam_candidate);
+  dsda_CopyBFCommandDepth(cmd, &bf);
+}
+
 static void dsda_CopyBFResult(bf_t* bf, int depth) {
   int i;
 
@@ -223,40 +351,19 @@ static void dsda_PrintBFProgress(void) {
   int percent;
   unsigned long long elapsed_time;
 
+  if (bf_worker_fd >= 0)
+    return;
+
   percent = 100 * bf_volume / bf_volume_max;
   elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
 
   lprintf(LO_INFO, "  %lld / %lld sequences tested (%d%%) in %.2f seconds!\n",
           bf_volume, bf_volume_max, percent, (float) elapsed_time / 1000);
-}
-
-#define BF_FAILURE 0
-#define BF_SUCCESS 1
-
-static const char* bf_result_text[2] = { "FAILURE", "SUCCESS" };
-static dboolean brute_force_ended;
 
-dboolean dsda_BruteForceEnded(void) {
-  return brute_force_ended;
-}
-
-static void dsda_EndBF(int result) {
-  brute_force_ended = true;
-
-  lprintf(LO_INFO, "Brute force complete (%s)!\n", bf_result_text[result]);
-  dsda_PrintBFProgress();
-
-  if (bf_nomonsters)
-    dsda_RestoreKeyFrame(&nomo_key_frame, true);
-  else
-    dsda_RestoreBFKeyFrame(0);
-
-  bf_mode = false;
-
-  if (result == BF_SUCCESS)
-    dsda_QueueBuildCommands(bf_result, bf_depth);
-  else
-    dsda_ExitSkipMode();
+  if (bf_prune)
+    lprintf(LO_INFO, "  %lld sequences pruned (%d%%), %d states stored\n",
+            bf_pruned, bf_volume ? (int) (100 * bf_pruned / bf_volume) : 0,
+            bf_transposition_count);
 }
 
 static fixed_t dsda_BFAttribute(int attribute) {
@@ -392,19 +499,17 @@ static dboolean dsda_BFConditionReached(int i) {
   }
 }
 
-static void dsda_BFUpdateBestResult(fixed_t value) {
+static void dsda_PrintBFBestResult(void) {
   int i;
+  fixed_t value;
   char str[FIXED_STRING_LENGTH];
   char cmd_str[COMMAND_MOVEMENT_STRING_LENGTH];
 
-  bf_target.evaluated = true;
-  bf_target.best_value = value;
-  bf_target.best_depth = true_logictic - bf_logictic;
-
-  for (i = 0; i < bf_target.best_depth; ++i)
-    bf_target.best_bf[i] = brute_force[i];
+  // Workers report to the parent instead
+  if (bf_worker_fd >= 0)
+    return;
 
-  dsda_CopyBFResult(bf_target.best_bf, bf_target.best_depth);
+  value = bf_target.best_value;
 
   if (fixed_point_attribute[bf_target.attribute])
     dsda_FixedToString(str, value);
@@ -421,22 +526,41 @@ static void dsda_BFUpdateBestResult(fixed_t value) {
   lprintf(LO_INFO, "\n");
 }
 
-static dboolean dsda_BFNewBestResult(fixed_t value) {
-  if (!bf_target.evaluated)
-    return true;
+static void dsda_BFUpdateBestResult(fixed_t value) {
+  int i;
+
+  bf_target.evaluated = true;
+  bf_target.best_value = value;
+  bf_target.best_depth = true_logictic - bf_logictic;
+
+  for (i = 0; i < bf_target.best_depth; ++i)
+    bf_target.best_bf[i] = brute_force[i];
 
+  dsda_CopyBFResult(bf_target.best_bf, bf_target.best_depth);
+
+  dsda_PrintBFBestResult();
+}
+
+static dboolean dsda_BFBetterValue(fixed_t value, fixed_t other) {
   switch (bf_target.limit) {
     case dsda_bf_acap:
-      return abs(value - bf_target.value) < abs(bf_target.best_value - bf_target.value);
+      return abs(value - bf_target.value) < abs(other - bf_target.value);
     case dsda_bf_max:
-      return value > bf_target.best_value;
+      return value > other;
     case dsda_bf_min:
-      return value < bf_target.best_value;
+      return value < other;
     default:
       return false;
   }
 }
 
+static dboolean dsda_BFNewBestResult(fixed_t value) {
+  if (!bf_target.evaluated)
+    return true;
+
+  return dsda_BFBetterValue(value, bf_target.best_value);
+}
+
 static void dsda_BFEvaluateTarget(void) {
   fixed_t value;
 
@@ -446,13 +570,21 @@ static void dsda_BFEvaluateTarget(void) {
     dsda_BFUpdateBestResult(value);
 }
 
-static dboolean dsda_BFConditionsReached(void) {
+static int dsda_BFConditionCount(void) {
   int i, reached;
 
   reached = 0;
   for (i = 0; i < bf_condition_count; ++i)
     reached += dsda_BFConditionReached(i);
 
+  return reached;
+}
+
+static dboolean dsda_BFConditionsReached(void) {
+  int reached;
+
+  reached = dsda_BFConditionCount();
+
   if (reached == bf_condition_count)
     if (bf_target.enabled) {
       dsda_BFEvaluateTarget();
@@ -463,6 +595,418 @@ static dboolean dsda_BFConditionsReached(void) {
   return reached == bf_condition_count;
 }
 
+static void dsda_ResetBFTranspositions(void) {
+  Z_Free(bf_transpositions);
+  bf_transpositions = NULL;
+  bf_transposition_size = 0;
+  bf_transposition_count = 0;
+  bf_pruned = 0;
+}
+
+static bf_transposition_t* dsda_FindBFTransposition(bf_transposition_t* table, int size,
+                                                    const bf_transposition_t* key) {
+  int i;
+  unsigned int h;
+
+  h = key->depth * 2654435761u;
+  h ^= (unsigned int) (key->hash ^ (key->hash >> 32));
+
+  for (i = h & (size - 1); table[i].depth; i = (i + 1) & (size - 1))
+    if (table[i].depth == key->depth && table[i].hash == key->hash)
+      break;
+
+  return &table[i];
+}
+
+static void dsda_GrowBFTranspositions(void) {
+  int i;
+  int old_size;
+  bf_transposition_t* old_table;
+
+  old_size = bf_transposition_size;
+  old_table = bf_transpositions;
+
+  bf_transposition_size = old_size ? old_size * 2 : 1 << 16;
+  bf_transpositions = Z_Calloc(bf_transposition_size, sizeof(*bf_transpositions));
+
+  for (i = 0; i < old_size; ++i)
+    if (old_table[i].depth)
+      *dsda_FindBFTransposition(bf_transpositions, bf_transposition_size, &old_table[i]) =
+        old_table[i];
+
+  Z_Free(old_table);
+}
+
+// Returns true if this state was already reached at this depth
+// Once the table is full, new states are no longer remembered
+// Stores the key frame for the frame, which is needed to hash the state
+static dboolean dsda_BFTransposition(int frame) {
+  bf_transposition_t key;
+  bf_transposition_t* entry;
+
+  dsda_StoreBFKeyFrame(frame);
+
+  key.depth = frame;
+  key.hash = dsda_KeyFrameStateHash(&brute_force[frame].key_frame);
+
+  if (bf_transposition_count * 2 >= bf_transposition_size &&
+      bf_transposition_size < BF_TRANSPOSITION_LIMIT * 2)
+    dsda_GrowBFTranspositions();
+
+  entry = dsda_FindBFTransposition(bf_transpositions, bf_transposition_size, &key);
+
+  if (entry->depth)
+    return true;
+
+  if (bf_transposition_count < BF_TRANSPOSITION_LIMIT) {
+    *entry = key;
+    ++bf_transposition_count;
+  }
+
+  return false;
+}
+
+#define BF_ERROR -1
+#define BF_FAILURE 0
+#define BF_SUCCESS 1
+
+static const char* bf_result_text[2] = { "FAILURE", "SUCCESS" };
+static dboolean brute_force_ended;
+
+dboolean dsda_BruteForceEnded(void) {
+  return brute_force_ended;
+}
+
+#ifndef _WIN32
+
+static dboolean dsda_WriteBFReport(const bf_worker_result_t* report) {
+  const char* p;
+  size_t left;
+
+  p = (const char*) report;
+  left = sizeof(*report);
+  while (left) {
+    ssize_t length;
+
+    length = write(bf_worker_fd, p, left);
+
+    if (length < 0) {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    p += length;
+    left -= length;
+  }
+
+  return true;
+}
+
+static void dsda_ReportBFResult(int result) {
+  bf_worker_result_t report;
+
+  memset(&report, 0, sizeof(report));
+  report.result = result;
+  report.volume = bf_volume;
+  report.pruned = bf_pruned;
+  report.evaluated = bf_target.evaluated;
+  report.best_value = bf_target.best_value;
+  report.best_depth = bf_target.best_depth;
+  memcpy(report.cmd, bf_result, sizeof(report.cmd));
+
+  if (!dsda_WriteBFReport(&report))
+    _exit(-1);
+
+  _exit(0);
+}
+
+// Workers must not run the exit sequence, which would overwrite the build
+//   demo and remove the zip temp dirs that the parent still uses
+void dsda_AbortBFWorker(void) {
+  bf_worker_result_t report;
+
+  if (bf_worker_fd < 0)
+    return;
+
+  memset(&report, 0, sizeof(report));
+  report.result = BF_ERROR;
+  dsda_WriteBFReport(&report);
+
+  _exit(-1);
+}
+
+static void dsda_ReadBFWorker(bf_worker_t* worker) {
+  char* p;
+  size_t left;
+  int status;
+
+  p = (char*) &worker->result;
+  left = sizeof(worker->result);
+  while (left) {
+    ssize_t length;
+
+    length = read(worker->fd, p, left);
+
+    if (length < 0 && errno == EINTR)
+      continue;
+
+    if (length <= 0) {
+      lprintf(LO_WARN, "Brute force worker %d did not finish cleanly\n", (int) (worker - bf_workers) + 1);
+      memset(&worker->result, 0, sizeof(worker->result));
+      worker->result.result = BF_FAILURE;
+      break;
+    }
+
+    p += length;
+    left -= length;
+  }
+
+  if (worker->result.result == BF_ERROR) {
+    lprintf(LO_WARN, "Brute force worker %d exited with an error\n", (int) (worker - bf_workers) + 1);
+    worker->result.result = BF_FAILURE;
+  }
+
+  close(worker->fd);
+  waitpid(worker->pid, &status, 0);
+  worker->done = true;
+}
+
+static void dsda_StopBFWorkers(void) {
+  int i;
+
+  for (i = 0; i < bf_worker_count; ++i)
+    if (!bf_workers[i].done) {
+      int status;
+
+      kill(bf_workers[i].pid, SIGKILL);
+      close(bf_workers[i].fd);
+      waitpid(bf_workers[i].pid, &status, 0);
+      bf_workers[i].done = true;
+    }
+}
+
+// Without a target, any sequence meeting the conditions is accepted
+static dboolean dsda_BFWorkerSucceeded(bf_worker_t* worker) {
+  if (bf_target.enabled || worker->result.result != BF_SUCCESS)
+    return false;
+
+  memcpy(bf_result, worker->result.cmd, sizeof(bf_result));
+
+  return true;
+}
+
+// Check for a worker that already found a solution
+static dboolean dsda_PollBFWorkers(void) {
+  int i;
+
+  for (i = 0; i < bf_worker_count; ++i) {
+    struct pollfd pfd;
+
+    if (bf_workers[i].done)
+      continue;
+
+    pfd.fd = bf_workers[i].fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, 0) <= 0)
+      continue;
+
+    dsda_ReadBFWorker(&bf_workers[i]);
+
+    if (dsda_BFWorkerSucceeded(&bf_workers[i]))
+      return true;
+  }
+
+  return false;
+}
+
+// Slices are merged in order, so ties go to the earliest sequence like in serial mode
+static int dsda_CollectBFWorkers(int result) {
+  int i;
+
+  if (!bf_workers)
+    return result;
+
+  if (result == BF_SUCCESS && !bf_target.enabled)
+    dsda_StopBFWorkers();
+
+  for (i = 0; i < bf_worker_count; ++i) {
+    bf_worker_t* worker = &bf_workers[i];
+
+    if (!worker->done) {
+      dsda_ReadBFWorker(worker);
+
+      if (dsda_BFWorkerSucceeded(worker)) {
+        result = BF_SUCCESS;
+        dsda_StopBFWorkers();
+      }
+    }
+
+    bf_volume += worker->result.volume;
+    bf_pruned += worker->result.pruned;
+
+    if (bf_target.enabled && worker->result.evaluated &&
+        dsda_BFNewBestResult(worker->result.best_value)) {
+      bf_target.evaluated = true;
+      bf_target.best_value = worker->result.best_value;
+      bf_target.best_depth = worker->result.best_depth;
+      memcpy(bf_result, worker->result.cmd, sizeof(bf_result));
+
+      dsda_PrintBFBestResult();
+    }
+  }
+
+  if (bf_target.enabled)
+    result = bf_target.evaluated ? BF_SUCCESS : BF_FAILURE;
+
+  bf_volume_max = bf_total_volume_max;
+
+  Z_Free(bf_workers);
+  bf_workers = NULL;
+  bf_worker_count = 0;
+  bf_split_frame = -1;
+
+  return result;
+}
+
+static void dsda_RunBFWorker(void) {
+  while (true) {
+    G_Ticker();
+    ++gametic;
+  }
+}
+
+// Workers are copies of the game at the start frame,
+//   they run the search directly without going through the main loop
+static void dsda_StartBFWorkers(void) {
+  int i;
+  int jobs;
+  long long volume;
+  long long split_volume;
+  dsda_arg_t* arg;
+
+  arg = dsda_Arg(dsda_arg_brute_force_jobs);
+  jobs = arg->value.v_int;
+  if (!jobs)
+    jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+  for (i = 0; i < bf_depth; ++i)
+    if (dsda_BFFrameVolume(&brute_force[i]) > 1)
+      break;
+
+  if (i == bf_depth)
+    return;
+
+  split_volume = dsda_BFFrameVolume(&brute_force[i]);
+
+  if (jobs > split_volume)
+    jobs = split_volume;
+
+  if (jobs < 2)
+    return;
+
+  bf_split_frame = i;
+  bf_total_volume_max = bf_volume_max;
+  volume = bf_volume_max / split_volume;
+
+  lprintf(LO_INFO, "Splitting frame %d across %d processes\n\n", bf_split_frame, jobs);
+
+  fflush(stdout);
+  fflush(stderr);
+
+  bf_workers = Z_Calloc(jobs - 1, sizeof(*bf_workers));
+  bf_worker_count = jobs - 1;
+
+  for (i = jobs - 1; i >= 0; --i) {
+    int fds[2];
+    int pid;
+
+    bf_split_index = split_volume * i / jobs;
+    bf_split_end = split_volume * (i + 1) / jobs;
+    bf_volume_max = (bf_split_end - bf_split_index) * volume;
+    dsda_SetBFFrameIndex(&brute_force[bf_split_frame], bf_split_index);
+
+    // The parent keeps the first slice
+    if (!i)
+      break;
+
+    if (pipe(fds))
+      I_Error("dsda_StartBFWorkers: pipe failed (%s)", strerror(errno));
+
+    pid = fork();
+
+    if (pid < 0)
+      I_Error("dsda_StartBFWorkers: fork failed (%s)", strerror(errno));
+
+    if (pid == 0) {
+      close(fds[0]);
+      bf_worker_fd = fds[1];
+
+      Z_Free(bf_workers);
+      bf_workers = NULL;
+      bf_worker_count = 0;
+
+      dsda_RunBFWorker();
+    }
+
+    close(fds[1]);
+    bf_workers[i - 1].pid = pid;
+    bf_workers[i - 1].fd = fds[0];
+  }
+}
+
+#else
+
+static void dsda_ReportBFResult(int result) {
+}
+
+void dsda_AbortBFWorker(void) {
+}
+
+static dboolean dsda_PollBFWorkers(void) {
+  return false;
+}
+
+static int dsda_CollectBFWorkers(int result) {
+  return result;
+}
+
+static void dsda_StartBFWorkers(void) {
+  if (dsda_Arg(dsda_arg_brute_force_jobs)->value.v_int != 1)
+    lprintf(LO_WARN, "-brute_force_jobs is not supported on this platform\n");
+}
+
+#endif
+
+static void dsda_EndBF(int result) {
+  if (bf_worker_fd >= 0)
+    dsda_ReportBFResult(result);
+
+  result = dsda_CollectBFWorkers(result);
+
+  brute_force_ended = true;
+
+  lprintf(LO_INFO, "Brute force complete (%s)!\n", bf_result_text[result]);
+  dsda_PrintBFProgress();
+
+  if (bf_nomonsters)
+    dsda_RestoreKeyFrame(&nomo_key_frame, true);
+  else
+    dsda_RestoreBFKeyFrame(0);
+
+  bf_mode = false;
+
+  if (result == BF_SUCCESS)
+    dsda_QueueBuildCommands(bf_result, bf_depth);
+  else
+    dsda_ExitSkipMode();
+
+  dsda_ResetBFTranspositions();
+}
+
 dboolean dsda_BruteForce(void) {
   return bf_mode;
 }
@@ -603,6 +1147,14 @@ void dsda_BruteForceWithMonsters(void) {
   bf_nomonsters = false;
 }
 
+void dsda_BruteForceWithPruning(void) {
+  bf_prune = true;
+}
+
+void dsda_BruteForceWithoutPruning(void) {
+  bf_prune = false;
+}
+
 dboolean dsda_StartBruteForce(int depth) {
   int i;
 
@@ -622,6 +1174,8 @@ dboolean dsda_StartBruteForce(int depth) {
   bf_logictic = true_logictic;
   bf_volume = 0;
   bf_volume_max = 1;
+  bf_poll_countdown = BF_POLL_INTERVAL;
+  dsda_ResetBFTranspositions();
 
   for (i = 0; i < bf_depth; ++i) {
     lprintf(LO_INFO, "  %d: F %d:%d S %d:%d T %d:%d B %d\n", i,
@@ -653,29 +1207,334 @@ dboolean dsda_StartBruteForce(int depth) {
 
   dsda_StartTimer(dsda_timer_brute_force);
 
+  dsda_StartBFWorkers();
+
+  return true;
+}
+
+static void dsda_FreeBeam(bf_beam_t* beam) {
+  int i;
+
+  for (i = 0; i < bf_beam_width; ++i) {
+    Z_Free(beam[i].key_frame.buffer);
+    Z_Free(beam[i].cmds);
+  }
+
+  Z_Free(beam);
+}
+
+static void dsda_EndBeamBF(int result) {
+  int i;
+  int best;
+  unsigned long long elapsed_time;
+
+  brute_force_ended = true;
+
+  best = -1;
+  for (i = 0; i < bf_beam_count; ++i)
+    if (best < 0 || dsda_BFBetterValue(bf_beam[i].value, bf_beam[best].value))
+      best = i;
+
+  if (best < 0)
+    result = BF_FAILURE;
+
+  elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
+
+  lprintf(LO_INFO, "Brute force complete (%s)!\n", bf_result_text[result]);
+  lprintf(LO_INFO, "  %lld sequences tested in %.2f seconds!\n",
+          bf_volume, (float) elapsed_time / 1000);
+
+  if (bf_nomonsters)
+    dsda_RestoreKeyFrame(&nomo_key_frame, true);
+  else
+    dsda_RestoreKeyFrame(&bf_beam_start, true);
+
+  bf_mode = false;
+
+  if (result == BF_SUCCESS)
+    dsda_QueueBuildCommands(bf_beam[best].cmds, bf_depth);
+  else
+    dsda_ExitSkipMode();
+
+  dsda_FreeBeam(bf_beam);
+  dsda_FreeBeam(bf_beam_next);
+  bf_beam = NULL;
+  bf_beam_next = NULL;
+  bf_beam_width = 0;
+
+  Z_Free(bf_beam_start.buffer);
+  bf_beam_start.buffer = NULL;
+
+  Z_Free(bf_beam_scratch.buffer);
+  bf_beam_scratch.buffer = NULL;
+}
+
+static void dsda_PrintBeamProgress(void) {
+  char str[FIXED_STRING_LENGTH];
+  unsigned long long elapsed_time;
+  fixed_t value;
+  int i;
+
+  if (!bf_beam_count)
+    return;
+
+  value = bf_beam[0].value;
+  for (i = 1; i < bf_beam_count; ++i)
+    if (dsda_BFBetterValue(bf_beam[i].value, value))
+      value = bf_beam[i].value;
+
+  if (fixed_point_attribute[bf_target.attribute])
+    dsda_FixedToString(str, value);
+  else
+    snprintf(str, FIXED_STRING_LENGTH, "%i", value);
+
+  elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
+
+  lprintf(LO_INFO, "  depth %d / %d: best %s = %s (%d kept, %lld sequences tested in %.2f seconds)\n",
+          bf_beam_frame, bf_depth, dsda_bf_attribute_names[bf_target.attribute], str,
+          bf_beam_count, bf_volume, (float) elapsed_time / 1000);
+}
+
+// Keep the state from the latest candidate if it ranks in the next beam
+static void dsda_KeepBeamCandidate(void) {
+  int i;
+  int slot;
+  fixed_t value;
+  uint64_t hash;
+  bf_beam_t* entry;
+  dsda_key_frame_t key_frame;
+
+  // Conditions only apply to the complete sequence
+  if (bf_beam_frame + 1 == bf_depth && dsda_BFConditionCount() != bf_condition_count)
+    return;
+
+  value = dsda_BFAttribute(bf_target.attribute);
+
+  if (bf_beam_next_count < bf_beam_width)
+    slot = bf_beam_next_count;
+  else {
+    slot = 0;
+    for (i = 1; i < bf_beam_next_count; ++i)
+      if (dsda_BFBetterValue(bf_beam_next[slot].value, bf_beam_next[i].value))
+        slot = i;
+
+    if (!dsda_BFBetterValue(value, bf_beam_next[slot].value))
+      return;
+  }
+
+  // Different commands often lead to the same state, which would crowd out the beam
+  dsda_StoreKeyFrame(&bf_beam_scratch, false, false);
+  hash = dsda_KeyFrameStateHash(&bf_beam_scratch);
+  for (i = 0; i < bf_beam_next_count; ++i)
+    if (bf_beam_next[i].hash == hash &&
+        dsda_KeyFrameStatesEqual(&bf_beam_next[i].key_frame, &bf_beam_scratch))
+      return;
+
+  if (slot == bf_beam_next_count)
+    ++bf_beam_next_count;
+
+  entry = &bf_beam_next[slot];
+  entry->hash = hash;
+  entry->value = value;
+
+  key_frame = entry->key_frame;
+  entry->key_frame = bf_beam_scratch;
+  bf_beam_scratch = key_frame;
+  memcpy(entry->cmds, bf_beam[bf_beam_parent].cmds, bf_beam_frame * sizeof(*entry->cmds));
+  dsda_CopyBeamCommand(&entry->cmds[bf_beam_frame]);
+}
+
+static void dsda_EvaluateBeam(void) {
+  if (!bf_beam_pending)
+    return;
+
+  bf_beam_pending = false;
+  ++bf_volume;
+
+  dsda_KeepBeamCandidate();
+
+  if (++bf_beam_candidate == dsda_BFFrameVolume(dsda_BeamFrame(bf_beam_frame))) {
+    bf_beam_candidate = 0;
+
+    if (++bf_beam_parent == bf_beam_count) {
+      bf_beam_t* temp;
+
+      temp = bf_beam;
+      bf_beam = bf_beam_next;
+      bf_beam_next = temp;
+
+      bf_beam_count = bf_beam_next_count;
+      bf_beam_next_count = 0;
+      bf_beam_parent = 0;
+      ++bf_beam_frame;
+
+      dsda_PrintBeamProgress();
+
+      if (!bf_beam_count || bf_beam_frame == bf_depth) {
+        dsda_EndBeamBF(BF_SUCCESS);
+        return;
+      }
+    }
+  }
+
+  dsda_RestoreKeyFrame(&bf_beam[bf_beam_parent].key_frame, true);
+}
+
+dboolean dsda_StartBeamBruteForce(int width, int depth) {
+  int i;
+
+  if (!dsda_BuildMode()) {
+    lprintf(LO_WARN, "You cannot start brute force outside of build mode!\n");
+    return false;
+  }
+
+  if (depth <= 0 || depth > MAX_BF_BEAM_DEPTH || width <= 0 || width > MAX_BF_BEAM_WIDTH)
+    return false;
+
+  if (!bf_target.enabled) {
+    lprintf(LO_WARN, "Beam search requires a target (acap, max, or min)!\n");
+    return false;
+  }
+
+  dsda_TrackFeature(uf_bruteforce);
+
+  lprintf(LO_INFO, "Beam search starting (width %d, depth %d):\n", width, depth);
+
+  for (i = 0; i < depth && i < MAX_BF_DEPTH; ++i) {
+    lprintf(LO_INFO, "  %d: F %d:%d S %d:%d T %d:%d B %d\n", i,
+            brute_force[i].forwardmove.min, brute_force[i].forwardmove.max,
+            brute_force[i].sidemove.min, brute_force[i].sidemove.max,
+            brute_force[i].angleturn.min, brute_force[i].angleturn.max,
+            brute_force[i].buttons);
+  }
+
+  if (depth > MAX_BF_DEPTH)
+    lprintf(LO_INFO, "  Frames after %d use the ranges of frame %d\n", MAX_BF_DEPTH - 1, MAX_BF_DEPTH - 1);
+
+  lprintf(LO_INFO, "\n");
+
+  bf_depth = depth;
+  bf_logictic = true_logictic;
+  bf_volume = 0;
+  bf_beam_width = width;
+  bf_beam_count = 1;
+  bf_beam_next_count = 0;
+  bf_beam_frame = 0;
+  bf_beam_parent = 0;
+  bf_beam_candidate = 0;
+  bf_beam_pending = false;
+
+  bf_beam = Z_Calloc(width, sizeof(*bf_beam));
+  bf_beam_next = Z_Calloc(width, sizeof(*bf_beam_next));
+  for (i = 0; i < width; ++i) {
+    bf_beam[i].cmds = Z_Calloc(depth, sizeof(ticcmd_t));
+    bf_beam_next[i].cmds = Z_Calloc(depth, sizeof(ticcmd_t));
+  }
+
+  bf_mode = true;
+
+  if (bf_nomonsters) {
+    lprintf(LO_INFO, "Warning: ignoring monsters! The result may desync with monsters!\n");
+    dsda_StoreKeyFrame(&nomo_key_frame, true, false);
+    P_RemoveMonsters();
+  }
+
+  dsda_StoreKeyFrame(&bf_beam_start, true, false);
+  dsda_StoreKeyFrame(&bf_beam[0].key_frame, false, false);
+
+  dsda_EnterSkipMode();
+
+  dsda_StartTimer(dsda_timer_brute_force);
+
   return true;
 }
 
 void dsda_UpdateBruteForce(void) {
   int frame;
 
+  if (bf_beam_width)
+    return;
+
   frame = true_logictic - bf_logictic;
 
   if (frame == bf_depth) {
-    if (bf_volume % 10000 == 0)
-      dsda_PrintBFProgress();
-
-    frame = dsda_AdvanceBruteForce();
+    frame = dsda_AdvanceBruteForce(bf_depth - 1);
 
     if (frame >= 0)
       dsda_RestoreBFKeyFrame(frame);
   }
-  else
+  else if (!bf_prune || !frame) // dsda_BFTransposition stores the rest
     dsda_StoreBFKeyFrame(frame);
 }
 
+static dboolean dsda_BFPollDue(void) {
+  if (--bf_poll_countdown > 0)
+    return false;
+
+  bf_poll_countdown = BF_POLL_INTERVAL;
+
+  dsda_PrintBFProgress();
+
+  return true;
+}
+
+static void dsda_EndExhaustedBF(void) {
+  if (bf_target.enabled && bf_target.evaluated)
+    dsda_EndBF(BF_SUCCESS);
+  else
+    dsda_EndBF(BF_FAILURE);
+}
+
+// Skip every sequence that continues from the current frame
+// Frames after the current one are still at the start of their ranges
+static void dsda_PruneBruteForce(int frame) {
+  int i;
+  long long volume;
+
+  volume = 1;
+  for (i = frame; i < bf_depth; ++i)
+    volume *= dsda_BFFrameVolume(&brute_force[i]);
+
+  bf_volume += volume;
+  bf_pruned += volume;
+
+  if (dsda_BFPollDue() && dsda_PollBFWorkers()) {
+    dsda_EndBF(BF_SUCCESS);
+    return;
+  }
+
+  // Nothing before the split frame has a choice
+  if (frame <= bf_split_frame)
+    i = -1;
+  else
+    i = dsda_AdvanceBruteForce(frame - 1);
+
+  if (i < 0) {
+    bf_volume = bf_volume_max;
+    dsda_EndExhaustedBF();
+  }
+  else
+    dsda_RestoreBFKeyFrame(i);
+}
+
 void dsda_EvaluateBruteForce(void) {
-  if (true_logictic - bf_logictic != bf_depth)
+  int frame;
+
+  if (bf_beam_width) {
+    dsda_EvaluateBeam();
+    return;
+  }
+
+  frame = true_logictic - bf_logictic;
+
+  if (bf_prune && frame > 0 && frame < bf_depth) {
+    if (dsda_BFTransposition(frame))
+      dsda_PruneBruteForce(frame);
+
+    return;
+  }
+
+  if (frame != bf_depth)
     return;
 
   ++bf_volume;
@@ -684,17 +1543,22 @@ void dsda_EvaluateBruteForce(void) {
     dsda_CopyBFResult(brute_force, bf_depth);
     dsda_EndBF(BF_SUCCESS);
   }
-  else if (bf_volume >= bf_volume_max) {
-    if (bf_target.enabled && bf_target.evaluated)
-      dsda_EndBF(BF_SUCCESS);
-    else
-      dsda_EndBF(BF_FAILURE);
-  }
+  else if (bf_volume >= bf_volume_max)
+    dsda_EndExhaustedBF();
+  else if (dsda_BFPollDue() && dsda_PollBFWorkers())
+    dsda_EndBF(BF_SUCCESS);
 }
 
 void dsda_CopyBruteForceCommand(ticcmd_t* cmd) {
   int depth;
 
+  if (bf_beam_width) {
+    dsda_CopyBeamCommand(cmd);
+    bf_beam_pending = true;
+
+    return;
+  }
+
   depth = true_logictic - bf_logictic;
 
   if (depth >= bf_depth) {
@@ -102,6 +102,7 @@ void dsda_AddMiscBruteForceCondition(dsda_bf_attribute_t attribute, fixed_t valu
 void dsda_AddBruteForceCondition(dsda_bf_attribute_t attribute,
                                  dsda_bf_operator_t operator, fixed_t value);
 dboolean dsda_StartBruteForce(int depth);
+dboolean dsda_StartBeamBruteForce(int width, int depth);
 int dsda_KeepBruteForceFrame(int i);
 int dsda_AddBruteForceFrame(int i,
                             int forwardmove_min, int forwardmove_max,
@@ -110,6 +111,9 @@ int dsda_AddBruteForceFrame(int i,
                             byte buttons);
 void dsda_BruteForceWithoutMonsters(void);
 void dsda_BruteForceWithMonsters(void);
+void dsda_BruteForceWithPruning(void);
+void dsda_BruteForceWithoutPruning(void);
 void dsda_UpdateBruteForce(void);
 void dsda_EvaluateBruteForce(void);
 void dsda_CopyBruteForceCommand(ticcmd_t* cmd);
+void dsda_AbortBFWorker(void);
@@ -29,6 +29,7 @@
 #include "dsda/playback.h"
 #include "dsda/settings.h"
 #include "dsda/skip.h"
+#include "dsda/state_hash.h"
 
 #include "build.h"
 
@@ -48,6 +49,24 @@ static int build_cmd_tic = -1;
 static dboolean replace_source = true;
 static build_cmd_queue_t cmd_queue;
 
+// The archive hash at the start of each recorded tic.
+// After an edit, the hashes from timeline_old_from on still describe the
+//   timeline that head_kf came from. Since the later commands are kept,
+//   matching one of them means the rest of that timeline is still valid.
+// The hash covers the whole archived state (not just the desync hash),
+//   so a match is safe to splice head_kf onto.
+// Hashes are only taken in build mode, for new tics at the end of the
+//   timeline and while a splice is pending. Tics from timeline_start up to
+//   timeline_count are covered.
+static uint64_t* timeline_hashes;
+static int timeline_start;
+static int timeline_count;
+static int timeline_capacity;
+static int timeline_old_from = -1;
+static dsda_key_frame_t head_kf;
+static int head_tic = -1;
+static dboolean splicing;
+
 static signed char forward50(void) {
   return dsda_Flag(dsda_arg_stroller) ?
          pclass[players[consoleplayer].pclass].forwardmove[0] :
@@ -82,10 +101,143 @@ static signed char minStrafeLeft(void) {
   return allow_turbo ? -128 : -strafe50();
 }
 
+void dsda_ResetBuildTimeline(void) {
+  timeline_start = 0;
+  timeline_count = 0;
+  timeline_old_from = -1;
+  head_tic = -1;
+  splicing = false;
+}
+
+static dboolean dsda_BuildTimelineDiverged(void) {
+  return timeline_old_from >= 0;
+}
+
+void dsda_MarkBuildEdit(int tic) {
+  if (dsda_BuildTimelineDiverged())
+    return;
+
+  if (head_tic > tic)
+    timeline_old_from = tic + 1;
+  else if (timeline_count > tic + 1)
+    timeline_count = MAX(tic + 1, timeline_start); // later hashes are stale
+}
+
+// Keep the furthest point of the timeline before leaving it
+static void dsda_StoreBuildHead(void) {
+  if (!demorecording || dsda_BuildTimelineDiverged() || true_logictic < head_tic)
+    return;
+
+  dsda_StoreKeyFrame(&head_kf, false, false);
+  head_tic = true_logictic;
+}
+
+void dsda_UpdateBuildTimeline(void) {
+  int tic;
+  uint64_t hash;
+
+  if (!dsda_BuildMode() || !demorecording || dsda_BruteForce())
+    return;
+
+  tic = true_logictic;
+
+  // Tics outside build mode were not hashed, so start over from here
+  // A pending splice can't be checked without the old hashes
+  if (tic < timeline_start || tic > timeline_count) {
+    if (dsda_BuildTimelineDiverged()) {
+      timeline_old_from = -1;
+      head_tic = -1;
+      splicing = false;
+    }
+
+    timeline_start = timeline_count = tic;
+  }
+
+  // Already hashed and nothing to compare
+  if (tic < timeline_count && (!dsda_BuildTimelineDiverged() || tic < timeline_old_from))
+    return;
+
+  if (timeline_count - timeline_start == timeline_capacity) {
+    timeline_capacity = timeline_capacity ? timeline_capacity * 2 : 35 * 60;
+    timeline_hashes = Z_Realloc(timeline_hashes, timeline_capacity * sizeof(*timeline_hashes));
+  }
+
+  hash = dsda_ArchiveStateHash();
+
+  if (dsda_BuildTimelineDiverged() && tic >= timeline_old_from) {
+    if (tic < timeline_count && timeline_hashes[tic - timeline_start] == hash) {
+      timeline_old_from = -1;
+      return;
+    }
+
+    timeline_old_from = tic + 1;
+
+    // Past the end of the old timeline, so this is the new head
+    if (timeline_old_from >= timeline_count) {
+      timeline_old_from = -1;
+      head_tic = -1;
+    }
+  }
+
+  timeline_hashes[tic - timeline_start] = hash;
+
+  if (tic == timeline_count)
+    ++timeline_count;
+}
+
+void dsda_EvaluateBuildSplice(void) {
+  if (!splicing)
+    return;
+
+  if (!dsda_SkipMode()) {
+    splicing = false;
+    return;
+  }
+
+  if (dsda_BuildTimelineDiverged())
+    return;
+
+  // The head must still be the state the old timeline reached there
+  if (head_tic >= timeline_start && head_tic < timeline_count &&
+      dsda_KeyFrameStateHash(&head_kf) != timeline_hashes[head_tic - timeline_start]) {
+    splicing = false;
+    return;
+  }
+
+  splicing = false;
+
+  if (head_tic > true_logictic) {
+    int tic = true_logictic;
+
+    dsda_RestoreKeyFrame(&head_kf, true);
+    doom_printf("Reconverged at tic %d", tic);
+  }
+
+  dsda_ExitSkipMode();
+}
+
+dboolean dsda_StartBuildSplice(void) {
+  if (!demorecording || head_tic <= true_logictic)
+    return false;
+
+  // Nothing changed since the head was stored
+  if (!dsda_BuildTimelineDiverged()) {
+    dsda_RestoreKeyFrame(&head_kf, true);
+    return true;
+  }
+
+  splicing = true;
+  dsda_SkipToLogicTic(head_tic);
+
+  return true;
+}
+
 void dsda_ChangeBuildCommand(void) {
   if (demoplayback)
     dsda_JoinDemo(NULL);
 
+  dsda_StoreBuildHead();
+
   replace_source = true;
   build_cmd_tic = true_logictic - 1;
   dsda_JumpToLogicTicFrom(true_logictic, true_logictic - 1);
@@ -548,6 +700,8 @@ dboolean dsda_BuildResponder(event_t* ev) {
       overwritten_logictic = true_logictic - 2;
       replace_source = false;
 
+      dsda_StoreBuildHead();
+      dsda_PlanCheckpoints(true_logictic - 1);
       dsda_JumpToLogicTic(true_logictic - 1);
     }
 
@@ -27,6 +27,11 @@ void dsda_CopyBuildCmd(ticcmd_t* cmd);
 void dsda_ReadBuildCmd(ticcmd_t* cmd);
 void dsda_EnterBuildMode(void);
 void dsda_RefreshBuildMode(void);
+void dsda_ResetBuildTimeline(void);
+void dsda_MarkBuildEdit(int tic);
+void dsda_UpdateBuildTimeline(void);
+void dsda_EvaluateBuildSplice(void);
+dboolean dsda_StartBuildSplice(void);
 dboolean dsda_BuildResponder(event_t *ev);
 void dsda_ToggleBuildTurbo(void);
 dboolean dsda_AdvanceFrame(void);
@@ -896,6 +896,10 @@ dsda_config_t dsda_config[dsda_config_count] = {
     "dsda_auto_key_frame_timeout", dsda_config_auto_key_frame_timeout,
     dsda_config_int, 0, 25, { 10 }, NULL, NOT_STRICT, dsda_InitKeyFrame
   },
+  [dsda_config_auto_key_frame_budget] = {
+    "dsda_auto_key_frame_budget", dsda_config_auto_key_frame_budget,
+    dsda_config_int, 0, 4096, { 128 }, NULL, NOT_STRICT, dsda_InitKeyFrame
+  },
   [dsda_config_auto_save] = {
     "dsda_config_auto_save", dsda_config_auto_save,
     CONF_BOOL(0)
@@ -1195,6 +1199,14 @@ dsda_config_t dsda_config[dsda_config_count] = {
     "render_stretchsky", dsda_config_render_stretchsky,
     CONF_BOOL(1)
   },
+  [dsda_config_render_threads] = {
+    "render_threads", dsda_config_render_threads,
+    dsda_config_int, 1, 16, { 1 }
+  },
+  [dsda_config_render_transposed] = {
+    "render_transposed", dsda_config_render_transposed,
+    CONF_BOOL(0)
+  },
   [dsda_config_gl_fade_mode] = {
     "gl_fade_mode", dsda_config_gl_fade_mode,
     dsda_config_int, 0, 1, { 0 }
@@ -195,6 +195,7 @@ typedef enum {
   dsda_config_auto_key_frame_interval,
   dsda_config_auto_key_frame_depth,
   dsda_config_auto_key_frame_timeout,
+  dsda_config_auto_key_frame_budget,
   dsda_config_auto_save,
   dsda_config_ex_text_scale_x,
   dsda_config_ex_text_ratio_y,
@@ -269,6 +270,8 @@ typedef enum {
   dsda_config_render_patches_scalex,
   dsda_config_render_patches_scaley,
   dsda_config_render_stretchsky,
+  dsda_config_render_threads,
+  dsda_config_render_transposed,
   dsda_config_boom_translucent_sprites,
   dsda_config_show_alive_monsters,
   dsda_config_left_analog_deadzone,
@@ -38,6 +38,7 @@
 #include "s_sound.h"
 #include "smooth.h"
 #include "v_video.h"
+#include "z_zone.h"
 
 #include "dsda.h"
 #include "dsda/build.h"
@@ -47,6 +48,7 @@
 #include "dsda/exhud.h"
 #include "dsda/features.h"
 #include "dsda/font.h"
+#include "dsda/frame_stats.h"
 #include "dsda/global.h"
 #include "dsda/map_format.h"
 #include "dsda/messenger.h"
@@ -54,6 +56,7 @@
 #include "dsda/playback.h"
 #include "dsda/settings.h"
 #include "dsda/stretch.h"
+#include "dsda/thinker_profile.h"
 #include "dsda/tracker.h"
 #include "dsda/utility.h"
 
@@ -854,6 +857,18 @@ static dboolean console_BruteForceMonsters(const char* command, const char* args
   return true;
 }
 
+static dboolean console_BruteForcePrune(const char* command, const char* args) {
+  dsda_BruteForceWithPruning();
+
+  return true;
+}
+
+static dboolean console_BruteForceNoPrune(const char* command, const char* args) {
+  dsda_BruteForceWithoutPruning();
+
+  return true;
+}
+
 static dboolean console_BruteForceFrame(const char* command, const char* args) {
   int frame;
   int forwardmove_min, forwardmove_max;
@@ -905,8 +920,7 @@ static dboolean console_BruteForceFrame(const char* command, const char* args) {
                                  buttons);
 }
 
-static dboolean console_BruteForceStart(const char* command, const char* args) {
-  int depth;
+static dboolean console_ParseBruteForce(const char* args, int* depth) {
   int forwardmove_min, forwardmove_max;
   int sidemove_min, sidemove_max;
   int angleturn_min, angleturn_max;
@@ -916,7 +930,7 @@ static dboolean console_BruteForceStart(const char* command, const char* args) {
   dsda_ResetBruteForceConditions();
 
   arg_count = sscanf(
-    args, "%i %i:%i %i:%i %i:%i %[^;]", &depth,
+    args, "%i %i:%i %i:%i %i:%i %[^;]", depth,
     &forwardmove_min, &forwardmove_max,
     &sidemove_min, &sidemove_max,
     &angleturn_min, &angleturn_max,
@@ -926,7 +940,7 @@ static dboolean console_BruteForceStart(const char* command, const char* args) {
   if (arg_count == 8) {
     int i;
 
-    for (i = 0; i < depth; ++i)
+    for (i = 0; i < *depth; ++i)
       dsda_AddBruteForceFrame(i,
                               forwardmove_min, forwardmove_max,
                               sidemove_min, sidemove_max,
@@ -934,7 +948,7 @@ static dboolean console_BruteForceStart(const char* command, const char* args) {
                               0);
   }
   else {
-    arg_count = sscanf(args, "%i %[^;]", &depth, condition_args);
+    arg_count = sscanf(args, "%i %[^;]", depth, condition_args);
 
     if (arg_count != 2)
       return false;
@@ -1048,15 +1062,88 @@ static dboolean console_BruteForceStart(const char* command, const char* args) {
     Z_Free(conditions);
   }
 
+  return true;
+}
+
+static dboolean console_BruteForceStart(const char* command, const char* args) {
+  int depth;
+
+  if (!console_ParseBruteForce(args, &depth))
+    return false;
+
   return dsda_StartBruteForce(depth);
 }
 
+static dboolean console_BruteForceBeam(const char* command, const char* args) {
+  int width, depth;
+  char bf_args[CONSOLE_ENTRY_SIZE];
+
+  if (sscanf(args, "%i %[^;]", &width, bf_args) != 2)
+    return false;
+
+  if (!console_ParseBruteForce(bf_args, &depth))
+    return false;
+
+  return dsda_StartBeamBruteForce(width, depth);
+}
+
 static dboolean console_BuildTurbo(const char* command, const char* args) {
   dsda_ToggleBuildTurbo();
 
   return true;
 }
 
+static dboolean console_BuildSplice(const char* command, const char* args) {
+  return dsda_StartBuildSplice();
+}
+
+static dboolean console_ThinkerProfileToggle(const char* command, const char* args) {
+  dsda_ToggleThinkerProfile();
+  dsda_RefreshExHudThinkerProfile();
+
+  return true;
+}
+
+static dboolean console_ThinkerProfilePrint(const char* command, const char* args) {
+  int limit;
+
+  if (sscanf(args, "%d", &limit) != 1)
+    limit = 10;
+
+  dsda_PrintThinkerProfile(limit);
+
+  return true;
+}
+
+static dboolean console_ThinkerProfileReset(const char* command, const char* args) {
+  dsda_ResetThinkerProfile();
+
+  return true;
+}
+
+static dboolean console_FrameTimesReset(const char* command, const char* args) {
+  dsda_ResetFrameStats();
+
+  return true;
+}
+
+static dboolean console_ZoneStatsPrint(const char* command, const char* args) {
+  int limit;
+
+  if (sscanf(args, "%d", &limit) != 1)
+    limit = 10;
+
+  Z_PrintSiteStats(limit);
+
+  return true;
+}
+
+static dboolean console_ZoneStatsReset(const char* command, const char* args) {
+  Z_ResetSiteStats();
+
+  return true;
+}
+
 static dboolean console_Exit(const char* command, const char* args) {
   extern void M_ClearMenus(void);
 
@@ -2409,6 +2496,8 @@ static console_command_entry_t console_commands[] = {
   // build mode
   { "brute_force.start", console_BruteForceStart, CF_DEMO },
   { "bf.start", console_BruteForceStart, CF_DEMO },
+  { "brute_force.beam", console_BruteForceBeam, CF_DEMO },
+  { "bf.beam", console_BruteForceBeam, CF_DEMO },
   { "brute_force.frame", console_BruteForceFrame, CF_DEMO },
   { "bf.frame", console_BruteForceFrame, CF_DEMO },
   { "brute_force.keep", console_BruteForceKeep, CF_DEMO },
@@ -2417,8 +2506,14 @@ static console_command_entry_t console_commands[] = {
   { "bf.nomo", console_BruteForceNoMonsters, CF_DEMO },
   { "brute_force.monsters", console_BruteForceMonsters, CF_DEMO },
   { "bf.mo", console_BruteForceMonsters, CF_DEMO },
+  { "brute_force.prune", console_BruteForcePrune, CF_DEMO },
+  { "bf.prune", console_BruteForcePrune, CF_DEMO },
+  { "brute_force.noprune", console_BruteForceNoPrune, CF_DEMO },
+  { "bf.noprune", console_BruteForceNoPrune, CF_DEMO },
   { "build.turbo", console_BuildTurbo, CF_DEMO },
   { "b.turbo", console_BuildTurbo, CF_DEMO },
+  { "build.splice", console_BuildSplice, CF_DEMO },
+  { "b.splice", console_BuildSplice, CF_DEMO },
   { "mf", console_BuildMF, CF_DEMO },
   { "mb", console_BuildMB, CF_DEMO },
   { "sr", console_BuildSR, CF_DEMO },
@@ -2442,6 +2537,14 @@ static console_command_entry_t console_commands[] = {
   { "game.quit", console_GameQuit, CF_ALWAYS },
   { "game.describe", console_GameDescribe, CF_ALWAYS },
 
+  // profiling
+  { "profile.thinkers", console_ThinkerProfileToggle, CF_ALWAYS },
+  { "profile.thinkers.print", console_ThinkerProfilePrint, CF_ALWAYS },
+  { "profile.thinkers.reset", console_ThinkerProfileReset, CF_ALWAYS },
+  { "profile.frame_times.reset", console_FrameTimesReset, CF_ALWAYS },
+  { "profile.zone", console_ZoneStatsPrint, CF_ALWAYS },
+  { "profile.zone.reset", console_ZoneStatsReset, CF_ALWAYS },
+
   // cheats
   { "idchoppers", console_BasicCheat, CF_DEMO },
   { "iddqd", console_BasicCheat, CF_DEMO },
@@ -0,0 +1,264 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Delta
+//
+
+#include <string.h>
+
+#include "lprintf.h"
+#include "z_zone.h"
+
+#include "delta.h"
+
+// A delta is the target length followed by a list of operations:
+//   copy:    DELTA_COPY offset length (bytes from the base)
+//   literal: DELTA_LITERAL length bytes...
+// Numbers are stored 7 bits at a time, low bits first.
+
+// Matches are found on blocks of the base aligned to DELTA_BLOCK bytes.
+// Save buffers shift when thinkers are added or removed, so a rolling hash
+//   of the target is used to find the new alignment.
+
+#define DELTA_COPY 0
+#define DELTA_LITERAL 1
+
+#define DELTA_BLOCK 16
+#define DELTA_PRIME 16777619u
+
+typedef struct {
+  byte* buffer;
+  int length;
+  int size;
+} delta_stream_t;
+
+static void dsda_EnsureDeltaSpace(delta_stream_t* stream, int length) {
+  if (stream->length + length <= stream->size)
+    return;
+
+  while (stream->length + length > stream->size)
+    stream->size = stream->size ? stream->size * 2 : 1024;
+
+  stream->buffer = Z_Realloc(stream->buffer, stream->size);
+}
+
+static void dsda_WriteDeltaNumber(delta_stream_t* stream, unsigned int value) {
+  dsda_EnsureDeltaSpace(stream, 5);
+
+  while (value >= 0x80) {
+    stream->buffer[stream->length++] = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+
+  stream->buffer[stream->length++] = value;
+}
+
+static void dsda_WriteDeltaLiteral(delta_stream_t* stream, const byte* data, int length) {
+  if (!length)
+    return;
+
+  dsda_WriteDeltaNumber(stream, DELTA_LITERAL);
+  dsda_WriteDeltaNumber(stream, length);
+
+  dsda_EnsureDeltaSpace(stream, length);
+  memcpy(stream->buffer + stream->length, data, length);
+  stream->length += length;
+}
+
+static void dsda_WriteDeltaCopy(delta_stream_t* stream, int offset, int length) {
+  dsda_WriteDeltaNumber(stream, DELTA_COPY);
+  dsda_WriteDeltaNumber(stream, offset);
+  dsda_WriteDeltaNumber(stream, length);
+}
+
+static unsigned int dsda_DeltaBlockHash(const byte* p) {
+  int i;
+  unsigned int h = 0;
+
+  for (i = 0; i < DELTA_BLOCK; ++i)
+    h = h * DELTA_PRIME + p[i];
+
+  return h;
+}
+
+byte* dsda_EncodeDelta(const byte* base, int base_length,
+                       const byte* target, int target_length, int* length) {
+  delta_stream_t stream = { 0 };
+  int* table;
+  int table_size;
+  int table_mask;
+  unsigned int top_power;
+  unsigned int h;
+  int block_count;
+  int literal_start;
+  int expected_shift;
+  int pos;
+  int i;
+
+  block_count = base_length / DELTA_BLOCK;
+
+  for (table_size = 1024; table_size < block_count * 2; table_size *= 2);
+  table_mask = table_size - 1;
+
+  table = Z_Malloc(table_size * sizeof(*table));
+  memset(table, -1, table_size * sizeof(*table));
+
+  for (i = 0; i < block_count; ++i) {
+    int slot;
+
+    slot = dsda_DeltaBlockHash(base + i * DELTA_BLOCK) & table_mask;
+
+    if (table[slot] < 0)
+      table[slot] = i * DELTA_BLOCK;
+  }
+
+  top_power = 1;
+  for (i = 1; i < DELTA_BLOCK; ++i)
+    top_power *= DELTA_PRIME;
+
+  dsda_WriteDeltaNumber(&stream, target_length);
+
+  literal_start = 0;
+  expected_shift = 0;
+  pos = 0;
+  h = target_length >= DELTA_BLOCK ? dsda_DeltaBlockHash(target) : 0;
+
+  while (pos + DELTA_BLOCK <= target_length) {
+    int match = -1;
+    int candidate;
+
+    // Most of the buffer lines up with the previous match
+    candidate = pos + expected_shift;
+    if (candidate >= 0 && candidate + DELTA_BLOCK <= base_length &&
+        !memcmp(base + candidate, target + pos, DELTA_BLOCK))
+      match = candidate;
+    else {
+      candidate = table[h & table_mask];
+
+      if (candidate >= 0 && !memcmp(base + candidate, target + pos, DELTA_BLOCK))
+        match = candidate;
+    }
+
+    if (match >= 0) {
+      int match_length;
+
+      // Pull the match back into the pending literal
+      while (pos > literal_start && match > 0 && base[match - 1] == target[pos - 1]) {
+        --pos;
+        --match;
+      }
+
+      match_length = DELTA_BLOCK;
+      while (pos + match_length < target_length && match + match_length < base_length &&
+             base[match + match_length] == target[pos + match_length])
+        ++match_length;
+
+      dsda_WriteDeltaLiteral(&stream, target + literal_start, pos - literal_start);
+      dsda_WriteDeltaCopy(&stream, match, match_length);
+
+      expected_shift = match - pos;
+      pos += match_length;
+      literal_start = pos;
+
+      if (pos + DELTA_BLOCK <= target_length)
+        h = dsda_DeltaBlockHash(target + pos);
+
+      continue;
+    }
+
+    if (pos + DELTA_BLOCK < target_length)
+      h = (h - target[pos] * top_power) * DELTA_PRIME + target[pos + DELTA_BLOCK];
+
+    ++pos;
+  }
+
+  dsda_WriteDeltaLiteral(&stream, target + literal_start, target_length - literal_start);
+
+  Z_Free(table);
+
+  *length = stream.length;
+
+  return stream.buffer;
+}
+
+static unsigned int dsda_ReadDeltaNumber(const byte** p, const byte* end) {
+  int shift = 0;
+  unsigned int value = 0;
+
+  while (1) {
+    if (*p >= end || shift > 28)
+      I_Error("dsda_DecodeDelta: corrupted delta");
+
+    value |= (**p & 0x7f) << shift;
+
+    if (!(*(*p)++ & 0x80))
+      break;
+
+    shift += 7;
+  }
+
+  return value;
+}
+
+byte* dsda_DecodeDelta(const byte* base, int base_length,
+                       const byte* delta, int delta_length, int* length) {
+  const byte* p;
+  const byte* end;
+  byte* result;
+  int result_length;
+  int pos;
+
+  p = delta;
+  end = delta + delta_length;
+
+  result_length = dsda_ReadDeltaNumber(&p, end);
+  result = Z_Malloc(result_length);
+
+  pos = 0;
+  while (p < end) {
+    unsigned int op, offset, size;
+
+    op = dsda_ReadDeltaNumber(&p, end);
+
+    if (op == DELTA_COPY) {
+      offset = dsda_ReadDeltaNumber(&p, end);
+      size = dsda_ReadDeltaNumber(&p, end);
+
+      if (offset > base_length || size > base_length - offset || size > result_length - pos)
+        I_Error("dsda_DecodeDelta: corrupted delta");
+
+      memcpy(result + pos, base + offset, size);
+    }
+    else if (op == DELTA_LITERAL) {
+      size = dsda_ReadDeltaNumber(&p, end);
+
+      if (size > end - p || size > result_length - pos)
+        I_Error("dsda_DecodeDelta: corrupted delta");
+
+      memcpy(result + pos, p, size);
+      p += size;
+    }
+    else
+      I_Error("dsda_DecodeDelta: corrupted delta");
+
+    pos += size;
+  }
+
+  if (pos != result_length)
+    I_Error("dsda_DecodeDelta: corrupted delta");
+
+  *length = result_length;
+
+  return result;
+}
@@ -0,0 +1,28 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Delta
+//
+
+#ifndef __DSDA_DELTA__
+#define __DSDA_DELTA__
+
+#include "doomtype.h"
+
+byte* dsda_EncodeDelta(const byte* base, int base_length,
+                       const byte* target, int target_length, int* length);
+byte* dsda_DecodeDelta(const byte* base, int base_length,
+                       const byte* delta, int delta_length, int* length);
+
+#endif
@@ -30,6 +30,7 @@
 
 #include "dsda.h"
 #include "dsda/args.h"
+#include "dsda/build.h"
 #include "dsda/configuration.h"
 #include "dsda/data_organizer.h"
 #include "dsda/excmd.h"
@@ -37,9 +38,11 @@
 #include "dsda/features.h"
 #include "dsda/key_frame.h"
 #include "dsda/map_format.h"
+#include "dsda/playback.h"
 #include "dsda/preferences.h"
 #include "dsda/settings.h"
 #include "dsda/split_tracker.h"
+#include "dsda/state_hash.h"
 #include "dsda/utility.h"
 
 #include "demo.h"
@@ -74,6 +77,7 @@ static dsda_demo_header_data_t dsda_demo_header_data;
 
 #define DF_FROM_KEYFRAME   0x01
 #define DF_CASUAL_FEATURES 0x02
+#define DF_STATE_CHECKSUMS 0x04
 
 static dboolean join_queued;
 static int dsda_demo_version;
@@ -81,6 +85,15 @@ static int bytes_per_tic;
 
 static dboolean use_demo_name_with_time;
 
+// State checksums are indexed by the tic they are taken on (every interval tics)
+// The recording buffer is only valid up to state_checksum_count, which is
+//   pulled back when an earlier tic is written again (e.g., after a rewind)
+static int state_checksum_interval;
+static unsigned int* state_checksums;
+static int state_checksum_count;
+static int state_checksum_capacity;
+static int state_checksum_desync_tic;
+
 int dsda_DemoTic(void) {
   return demo_tics;
 }
@@ -310,6 +323,12 @@ void dsda_InitDemoRecording(void) {
   dsda_demo_write_buffer_length = INITIAL_DEMO_BUFFER_SIZE;
 
   demo_tics = 0;
+
+  dsda_ResetBuildTimeline();
+
+  state_checksum_interval = dsda_Flag(dsda_arg_record_state_checksums) ?
+                            dsda_Arg(dsda_arg_record_state_checksums)->value.v_int : 0;
+  state_checksum_count = 0;
 }
 
 static void dsda_SetDemoBufferOffset(int offset) {
@@ -347,6 +366,13 @@ void dsda_WriteQueueToDemo(const void* buffer, size_t length) {
 }
 
 void dsda_WriteTicToDemo(const void* buffer, size_t length) {
+  // Overwriting a pending tic with a different command changes the future
+  if (dsda_DemoBufferOffset() + length <= largest_real_offset &&
+      memcmp(dsda_demo_write_buffer_p, buffer, length)) {
+    dsda_ForgetCheckpointsAfter(true_logictic);
+    dsda_MarkBuildEdit(true_logictic);
+  }
+
   dsda_WriteToDemo(buffer, length);
   ++demo_tics;
 }
@@ -442,7 +468,7 @@ const byte* dsda_EvaluateDemoStartPoint(const byte* demo_p) {
   return demo_p;
 }
 
-void dsda_GetDemoCheckSum(dsda_cksum_t* cksum, byte* features, byte* demo, size_t demo_size) {
+void dsda_GetDemoCheckSum(dsda_cksum_t* cksum, const byte* features, const byte* demo, size_t demo_size) {
   struct MD5Context md5;
 
   MD5Init(&md5);
@@ -464,6 +490,174 @@ void dsda_GetDemoRecordingCheckSum(dsda_cksum_t* cksum) {
   dsda_GetDemoCheckSum(cksum, features, dsda_demo_write_buffer, dsda_DemoBufferOffset());
 }
 
+static int dsda_PlayerCount(void) {
+  int i;
+  int count = 0;
+
+  for (i = 0; i < g_maxplayers; ++i)
+    if (playeringame[i])
+      ++count;
+
+  return count ? count : 1;
+}
+
+static void dsda_RecordStateChecksum(int tic) {
+  int index;
+
+  index = tic / state_checksum_interval - 1;
+
+  // A gap means the earlier part of the demo came from elsewhere (e.g., a key frame file)
+  if (index > state_checksum_count)
+    return;
+
+  if (index >= state_checksum_capacity) {
+    state_checksum_capacity = state_checksum_capacity ? state_checksum_capacity * 2 : 1024;
+    state_checksums = Z_Realloc(state_checksums, state_checksum_capacity * sizeof(*state_checksums));
+  }
+
+  state_checksums[index] = dsda_CombinedStateHash();
+  state_checksum_count = index + 1;
+}
+
+static void dsda_VerifyStateChecksum(int tic) {
+  int index;
+
+  index = tic / state_checksum_interval - 1;
+
+  if (index >= state_checksum_count || state_checksum_desync_tic)
+    return;
+
+  if (state_checksums[index] == dsda_CombinedStateHash())
+    return;
+
+  state_checksum_desync_tic = tic;
+
+  if (!dsda_Flag(dsda_arg_verify_state_checksums)) {
+    lprintf(LO_WARN, "State checksum mismatch at tic %d\n", tic);
+    return;
+  }
+
+  if (!dsda_Flag(dsda_arg_playdemolist))
+    I_Error("State checksum mismatch at tic %d", tic);
+
+  lprintf(LO_WARN, "State checksum mismatch at tic %d, skipping to the next demo\n", tic);
+  G_CheckDemoStatus();
+}
+
+// Called once per game tic, after the commands for the tic are known
+//   but before any of them have been applied
+void dsda_UpdateStateChecksums(void) {
+  int tic;
+
+  if (!state_checksum_interval)
+    return;
+
+  if (demorecording) {
+    tic = demo_tics / dsda_PlayerCount();
+
+    if (tic && !(tic % state_checksum_interval))
+      dsda_RecordStateChecksum(tic);
+  }
+  else if (demoplayback) {
+    tic = dsda_PlaybackTics() / dsda_PlayerCount();
+
+    if (tic && !(tic % state_checksum_interval))
+      dsda_VerifyStateChecksum(tic);
+  }
+}
+
+int dsda_StateChecksumDesyncTic(void) {
+  return state_checksum_desync_tic;
+}
+
+static void dsda_WriteStateChecksums(void) {
+  int i;
+  int count;
+  byte buffer[4];
+  byte* p;
+
+  if (!dsda_demo_version || !state_checksum_interval)
+    return;
+
+  dsda_SetExtraDemoHeaderFlag(DF_STATE_CHECKSUMS);
+
+  count = demo_tics / dsda_PlayerCount() / state_checksum_interval;
+  if (count > state_checksum_count)
+    count = state_checksum_count;
+
+  p = buffer;
+  dsda_WriteIntToHeader(&p, state_checksum_interval);
+  dsda_WriteToDemo(buffer, 4);
+
+  p = buffer;
+  dsda_WriteIntToHeader(&p, count);
+  dsda_WriteToDemo(buffer, 4);
+
+  for (i = 0; i < count; ++i) {
+    p = buffer;
+    dsda_WriteIntToHeader(&p, state_checksums[i]);
+    dsda_WriteToDemo(buffer, 4);
+  }
+}
+
+// The checksum block sits between the end marker and the footer
+// p points just past the end marker
+static size_t dsda_StateChecksumBlockSize(const byte* p, size_t size, int version, byte flags) {
+  size_t block_size;
+
+  if (!version || !(flags & DF_STATE_CHECKSUMS) || size < 8)
+    return 0;
+
+  block_size = 8 + 4 * (size_t) dsda_ReadIntFromHeader(p + 4);
+
+  return block_size > size ? 0 : block_size;
+}
+
+void dsda_LoadStateChecksums(const byte* buffer, int length) {
+  int i;
+  const byte* p;
+
+  // Recording owns the buffer (e.g., -recordfromto)
+  if (demorecording)
+    return;
+
+  state_checksum_interval = 0;
+  state_checksum_count = 0;
+  state_checksum_desync_tic = 0;
+
+  // dsda_demo_version is stale for other formats
+  if (*buffer != 255 || !dsda_demo_version)
+    return;
+
+  p = buffer + dsda_demo_header_data.end_marker_location + 1;
+
+  if (!dsda_StateChecksumBlockSize(p, length - (p - buffer),
+                                   dsda_demo_version, dsda_demo_header_data.flags)) {
+    if (dsda_demo_header_data.flags & DF_STATE_CHECKSUMS)
+      lprintf(LO_WARN, "dsda_LoadStateChecksums: state checksum block is corrupted\n");
+
+    return;
+  }
+
+  state_checksum_interval = dsda_ReadIntFromHeader(p);
+  state_checksum_count = dsda_ReadIntFromHeader(p + 4);
+  p += 8;
+
+  if (state_checksum_interval <= 0) {
+    state_checksum_interval = 0;
+    state_checksum_count = 0;
+    return;
+  }
+
+  if (state_checksum_count > state_checksum_capacity) {
+    state_checksum_capacity = state_checksum_count;
+    state_checksums = Z_Realloc(state_checksums, state_checksum_capacity * sizeof(*state_checksums));
+  }
+
+  for (i = 0; i < state_checksum_count; ++i, p += 4)
+    state_checksums[i] = dsda_ReadIntFromHeader(p);
+}
+
 static int dsda_ExportDemoToFile(const char* demo_name) {
   int end_marker_location;
   byte end_marker = DEMOMARKER;
@@ -473,6 +667,8 @@ static int dsda_ExportDemoToFile(const char* demo_name) {
 
   dsda_WriteToDemo(&end_marker, 1);
 
+  dsda_WriteStateChecksums();
+
   dsda_WriteExtraDemoHeaderData(end_marker_location);
 
   dsda_WriteExDemoFooter();
@@ -625,6 +821,8 @@ void dsda_RestoreDemoData(byte complete) {
   P_LOAD_X(demo_tics);
 
   if (complete && demo_write_buffer_offset) {
+    dsda_ForgetCheckpointsAfter(-1);
+    dsda_ResetBuildTimeline();
     dsda_SetDemoBufferOffset(0);
     dsda_WriteToDemo(save_p, demo_write_buffer_offset);
     save_p += demo_write_buffer_offset;
@@ -660,8 +858,11 @@ void dsda_JoinDemoCmd(ticcmd_t* cmd) {
     dsda_QueueJoin();
 }
 
-static const byte* dsda_ReadDSDADemoHeader(const byte* demo_p, const byte* header_p, size_t size) {
-  dsda_demo_version = 0;
+// Parses into the given header, so a demo file can be inspected without
+//   touching the playback state
+static const byte* dsda_ParseDSDADemoHeader(const byte* demo_p, const byte* header_p, size_t size,
+                                            int* version, dsda_demo_header_data_t* header) {
+  *version = 0;
 
   // 7 = 6 (signature) + 1 (dsda version)
   if (demo_p - header_p + 7 > size)
@@ -678,29 +879,39 @@ static const byte* dsda_ReadDSDADemoHeader(const byte* demo_p, const byte* heade
   if (*demo_p++ != 0xe6)
     return NULL;
 
-  dsda_demo_version = *demo_p++;
+  *version = *demo_p++;
 
-  if (dsda_demo_version > DSDA_DEMO_VERSION)
+  if (*version > DSDA_DEMO_VERSION)
     return NULL;
 
-  if (demo_p - header_p + dsda_demo_header_data_size[dsda_demo_version] > size)
+  if (demo_p - header_p + dsda_demo_header_data_size[*version] > size)
     return NULL;
 
-  dsda_demo_header_data.end_marker_location = dsda_ReadIntFromHeader(demo_p);
+  header->end_marker_location = dsda_ReadIntFromHeader(demo_p);
   demo_p += 4;
 
-  dsda_demo_header_data.demo_tics = dsda_ReadIntFromHeader(demo_p);
+  header->demo_tics = dsda_ReadIntFromHeader(demo_p);
   demo_p += 4;
 
-  if (dsda_demo_version >= 2)
-    dsda_demo_header_data.flags = *demo_p++;
+  if (*version >= 2)
+    header->flags = *demo_p++;
   else
-    dsda_demo_header_data.flags = 0;
+    header->flags = 0;
 
-  if (dsda_demo_version >= 3)
-    dsda_demo_header_data.udmf_version = *demo_p++;
+  if (*version >= 3)
+    header->udmf_version = *demo_p++;
   else
-    dsda_demo_header_data.udmf_version = 0;
+    header->udmf_version = 0;
+
+  return demo_p;
+}
+
+static const byte* dsda_ReadDSDADemoHeader(const byte* demo_p, const byte* header_p, size_t size) {
+  demo_p = dsda_ParseDSDADemoHeader(demo_p, header_p, size,
+                                    &dsda_demo_version, &dsda_demo_header_data);
+
+  if (!demo_p)
+    return NULL;
 
   dsda_EnableExCmd();
 
@@ -710,6 +921,19 @@ static const byte* dsda_ReadDSDADemoHeader(const byte* demo_p, const byte* heade
   return demo_p;
 }
 
+// Returns the dsda version of a whole demo file (0 for other formats)
+static int dsda_ParseDemoFileHeader(const byte* buffer, size_t size, dsda_demo_header_data_t* header) {
+  int version;
+
+  if (size < 1 || *buffer != 255)
+    return 0;
+
+  if (!dsda_ParseDSDADemoHeader(buffer + 1, buffer, size, &version, header))
+    return 0;
+
+  return version;
+}
+
 // Strip off the defunct extended header (if we understand it) or abort (if we don't)
 static const byte* dsda_ReadUMAPINFODemoHeader(const byte* demo_p, const byte* header_p, size_t size) {
   // 9 = 6 (signature) + 1 (version) + 2 (extension count)
@@ -813,6 +1037,10 @@ void dsda_ApplyDSDADemoFormat(byte** demo_p) {
     dsda_EnableCasualExCmdFeatures();
   }
 
+  // The checksums are stored in the dsda format footer
+  if (dsda_Flag(dsda_arg_record_state_checksums))
+    use_dsda_format = true;
+
   if (use_dsda_format)
   {
     dsda_EnableExCmd();
@@ -835,18 +1063,32 @@ int dsda_DemoTicsCount(const byte* p, const byte* demobuffer, int demolength) {
   return count / demo_playerscount;
 }
 
-const byte* dsda_DemoMarkerPosition(byte* buffer, size_t file_size) {
+// The header is parsed from the buffer itself, since the playback state may
+//   belong to another demo (e.g., the previous entry of a playback list)
+const byte* dsda_DemoMarkerPosition(byte* buffer, size_t file_size, size_t* checksum_block_size) {
   const byte* p;
+  dsda_demo_header_data_t header;
+  int version;
+
+  *checksum_block_size = 0;
 
   // read demo header
   p = G_ReadDemoHeaderEx(buffer, file_size, RDH_SKIP_HEADER);
 
-  if (dsda_demo_version) {
-    p = (const byte*) (buffer + dsda_demo_header_data.end_marker_location);
+  version = dsda_ParseDemoFileHeader(buffer, file_size, &header);
+
+  if (version) {
+    if (header.end_marker_location < 0 || (size_t) header.end_marker_location >= file_size)
+      return NULL;
+
+    p = (const byte*) (buffer + header.end_marker_location);
 
     if (*p != DEMOMARKER)
       return NULL;
 
+    *checksum_block_size = dsda_StateChecksumBlockSize(p + 1, file_size - (p + 1 - buffer),
+                                                       version, header.flags);
+
     return p;
   }
 
@@ -45,13 +45,16 @@ void dsda_JoinDemoCmd(ticcmd_t* cmd);
 const byte* dsda_StripDemoVersion255(const byte* demo_p, const byte* header_p, size_t size);
 void dsda_WriteDSDADemoHeader(byte** p);
 void dsda_ApplyDSDADemoFormat(byte** demo_p);
-void dsda_GetDemoCheckSum(dsda_cksum_t* cksum, byte* features, byte* demo, size_t demo_size);
+void dsda_GetDemoCheckSum(dsda_cksum_t* cksum, const byte* features, const byte* demo, size_t demo_size);
 void dsda_GetDemoRecordingCheckSum(dsda_cksum_t* cksum);
 void dsda_EndDemoRecording(void);
 int dsda_DemoDataSize(byte complete);
 void dsda_StoreDemoData(byte complete);
 void dsda_RestoreDemoData(byte complete);
 int dsda_DemoTicsCount(const byte* p, const byte* demobuffer, int demolength);
-const byte* dsda_DemoMarkerPosition(byte* buffer, size_t file_size);
+const byte* dsda_DemoMarkerPosition(byte* buffer, size_t file_size, size_t* checksum_block_size);
+void dsda_LoadStateChecksums(const byte* buffer, int length);
+void dsda_UpdateStateChecksums(void);
+int dsda_StateChecksumDesyncTic(void);
 
 #endif
@@ -48,6 +48,37 @@ typedef struct {
 
 static exdemo_t exdemo;
 
+// Args that a demo footer may override, restored before loading another demo
+static const dsda_arg_identifier_t footer_args[] = {
+  dsda_arg_complevel,
+  dsda_arg_solo_net,
+  dsda_arg_coop_spawns,
+  dsda_arg_chain_episodes,
+  dsda_arg_emulate,
+  dsda_arg_respawn,
+  dsda_arg_fast,
+  dsda_arg_nomonsters,
+};
+
+#define FOOTER_ARG_COUNT (sizeof(footer_args) / sizeof(footer_args[0]))
+
+static dsda_arg_t footer_arg_defaults[FOOTER_ARG_COUNT];
+static dboolean footer_args_stored;
+
+// Resource args are fixed once the first demo's files are loaded
+static const dsda_arg_identifier_t footer_resource_args[] = {
+  dsda_arg_iwad,
+  dsda_arg_file,
+  dsda_arg_deh,
+};
+
+#define FOOTER_RESOURCE_ARG_COUNT (sizeof(footer_resource_args) / sizeof(footer_resource_args[0]))
+
+static dsda_arg_t footer_resource_arg_defaults[FOOTER_RESOURCE_ARG_COUNT];
+
+// Resources named by the current footer, in the form DemoEx_AddResources writes
+static char* footer_resources;
+
 #define DEMOEX_PORTNAME_LUMPNAME "PORTNAME"
 #define DEMOEX_PARAMS_LUMPNAME "CMDLINE"
 #define DEMOEX_FEATURE_LUMPNAME "FEATURES"
@@ -92,7 +123,7 @@ static char* DemoEx_LumpAsString(const char* name, const wadinfo_t* header) {
   return str;
 }
 
-static void DemoEx_GetParams(const wadinfo_t* header) {
+static void DemoEx_GetParams(const wadinfo_t* header, dboolean load_resources) {
   char* str;
   char** params;
   int i, p, paramscount;
@@ -117,7 +148,29 @@ static void DemoEx_GetParams(const wadinfo_t* header) {
 
     M_ParseCmdLine(str, params, ((char*) params) + sizeof(char*) * paramscount, &paramscount, &i);
 
-    if (!dsda_Flag(dsda_arg_iwad) && !dsda_Flag(dsda_arg_file)) {
+    {
+      dsda_string_t resources;
+
+      dsda_InitString(&resources, NULL);
+
+      for (i = 0; files[i].param; ++i) {
+        p = M_CheckParmEx(files[i].param, params, paramscount);
+        if (p >= 0 && p + 1 != paramscount && *params[p + 1] != '-') {
+          dsda_StringCat(&resources, files[i].param);
+          dsda_StringCat(&resources, " ");
+
+          while (++p != paramscount && *params[p] != '-') {
+            dsda_StringCat(&resources, "\"");
+            dsda_StringCat(&resources, params[p]);
+            dsda_StringCat(&resources, "\" ");
+          }
+        }
+      }
+
+      footer_resources = resources.string;
+    }
+
+    if (load_resources && !dsda_Flag(dsda_arg_iwad) && !dsda_Flag(dsda_arg_file)) {
       for (i = 0; files[i].param; ++i) {
         p = M_CheckParmEx(files[i].param, params, paramscount);
         if (p >= 0) {
@@ -235,19 +288,16 @@ static void DemoEx_GetParams(const wadinfo_t* header) {
   Z_Free(str);
 }
 
-static void DemoEx_AddParams(wadtbl_t* wadtbl) {
+static void DemoEx_AddResources(dsda_string_t* files) {
   dsda_arg_t* arg;
   size_t i;
-  char buf[200];
 
   const char* filename_p;
 
-  dsda_string_t files;
   dsda_string_t iwad;
   dsda_string_t pwads;
   dsda_string_t dehs;
 
-  dsda_InitString(&files, NULL);
   dsda_InitString(&iwad, NULL);
   dsda_InitString(&pwads, NULL);
   dsda_InitString(&dehs, NULL);
@@ -295,20 +345,35 @@ static void DemoEx_AddParams(wadtbl_t* wadtbl) {
   }
 
   if (iwad.string) {
-    dsda_StringCat(&files, "-iwad ");
-    dsda_StringCat(&files, iwad.string);
+    dsda_StringCat(files, "-iwad ");
+    dsda_StringCat(files, iwad.string);
   }
 
   if (pwads.string) {
-    dsda_StringCat(&files, "-file ");
-    dsda_StringCat(&files, pwads.string);
+    dsda_StringCat(files, "-file ");
+    dsda_StringCat(files, pwads.string);
   }
 
   if (dehs.string) {
-    dsda_StringCat(&files, "-deh ");
-    dsda_StringCat(&files, dehs.string);
+    dsda_StringCat(files, "-deh ");
+    dsda_StringCat(files, dehs.string);
   }
 
+  dsda_FreeString(&iwad);
+  dsda_FreeString(&pwads);
+  dsda_FreeString(&dehs);
+}
+
+static void DemoEx_AddParams(wadtbl_t* wadtbl) {
+  dsda_arg_t* arg;
+  char buf[200];
+
+  dsda_string_t files;
+
+  dsda_InitString(&files, NULL);
+
+  DemoEx_AddResources(&files);
+
   // add complevel for formats which do not have it in header
   if (demo_compatibility) {
     sprintf(buf, "-complevel %d ", compatibility_level);
@@ -378,9 +443,6 @@ static void DemoEx_AddParams(wadtbl_t* wadtbl) {
                      (const byte*) files.string, strlen(files.string));
 
   dsda_FreeString(&files);
-  dsda_FreeString(&iwad);
-  dsda_FreeString(&pwads);
-  dsda_FreeString(&dehs);
 }
 
 int dsda_IsExDemoSigned(void) {
@@ -463,13 +525,16 @@ static void PartitionDemo(const char* filename) {
 
   if (file_size > 0) {
     const byte* p;
+    size_t checksum_block_size;
 
-    p = dsda_DemoMarkerPosition(exdemo.demo, file_size);
+    p = dsda_DemoMarkerPosition(exdemo.demo, file_size, &checksum_block_size);
 
     if (p) {
       //skip DEMOMARKER
       p++;
 
+      p += checksum_block_size;
+
       exdemo.demo_size = p - exdemo.demo;
 
       //seach for the "PWAD" signature after ENDDEMOMARKER
@@ -526,9 +591,66 @@ void dsda_WriteExDemoFooter(void) {
   FreePWADTable(&demoex);
 }
 
+static void StoreFooterArgs(void) {
+  int i;
+
+  for (i = 0; i < FOOTER_ARG_COUNT; ++i)
+    footer_arg_defaults[i] = *dsda_Arg(footer_args[i]);
+
+  footer_args_stored = true;
+}
+
+static void StoreFooterResourceArgs(void) {
+  int i;
+
+  for (i = 0; i < FOOTER_RESOURCE_ARG_COUNT; ++i)
+    footer_resource_arg_defaults[i] = *dsda_Arg(footer_resource_args[i]);
+}
+
+static void RestoreFooterArgs(void) {
+  int i;
+  overrun_list_t overflow;
+
+  for (i = 0; i < FOOTER_ARG_COUNT; ++i) {
+    dsda_arg_t* arg;
+
+    arg = dsda_Arg(footer_args[i]);
+
+    // The footer value is a copy made by dsda_UpdateStringArg
+    if (footer_args[i] == dsda_arg_emulate &&
+        arg->value.v_string != footer_arg_defaults[i].value.v_string)
+      Z_Free((char*) arg->value.v_string);
+
+    *arg = footer_arg_defaults[i];
+  }
+
+  for (i = 0; i < FOOTER_RESOURCE_ARG_COUNT; ++i)
+    *dsda_Arg(footer_resource_args[i]) = footer_resource_arg_defaults[i];
+
+  for (overflow = 0; overflow < OVERFLOW_MAX; overflow++)
+    overflows[overflow].footer = false;
+
+  spechit_baseaddr = 0;
+}
+
 void dsda_LoadExDemo(const char* filename) {
+  dboolean load_resources;
+
+  load_resources = !footer_args_stored;
+
+  if (footer_args_stored)
+    RestoreFooterArgs();
+  else
+    StoreFooterArgs();
+
+  ForgetExDemo();
   PartitionDemo(filename);
 
+  if (footer_resources) {
+    Z_Free(footer_resources);
+    footer_resources = NULL;
+  }
+
   if (exdemo.footer)
   {
     wadinfo_t* header;
@@ -540,11 +662,33 @@ void dsda_LoadExDemo(const char* filename) {
     else {
       DemoEx_GetFeatures(header);
 
-      // get needed wads and dehs
+      // get needed wads and dehs (only for the first demo)
       // restore all critical params like -spechit x
-      DemoEx_GetParams(header);
+      DemoEx_GetParams(header, load_resources);
     }
   }
+
+  if (load_resources)
+    StoreFooterResourceArgs();
+}
+
+// Returns the footer's resource list if it differs from the loaded one
+const char* dsda_ExDemoResourceMismatch(void) {
+  const char* result = NULL;
+  dsda_string_t loaded;
+
+  if (!footer_resources)
+    return NULL;
+
+  dsda_InitString(&loaded, NULL);
+  DemoEx_AddResources(&loaded);
+
+  if (strcasecmp(footer_resources, loaded.string ? loaded.string : ""))
+    result = footer_resources;
+
+  dsda_FreeString(&loaded);
+
+  return result;
 }
 
 int dsda_CopyExDemo(const byte** buffer, int* length) {
@@ -24,6 +24,7 @@ int dsda_IsExDemoSigned(void);
 void dsda_MergeExDemoFeatures(void);
 void dsda_LoadExDemo(const char* filename);
 int dsda_CopyExDemo(const byte** buffer, int* length);
+const char* dsda_ExDemoResourceMismatch(void);
 void dsda_WriteExDemoFooter(void);
 
 #endif
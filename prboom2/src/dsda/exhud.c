@@ -32,6 +32,7 @@
 #include "dsda/hud_components.h"
 #include "dsda/render_stats.h"
 #include "dsda/settings.h"
+#include "dsda/thinker_profile.h"
 #include "dsda/utility.h"
 
 #include "exhud.h"
@@ -69,7 +70,9 @@ typedef enum {
   exhud_tracker,
   exhud_weapon_text,
   exhud_render_stats,
+  exhud_thinker_profile,
   exhud_fps,
+  exhud_frame_histogram,
   exhud_attempts,
   exhud_local_time,
   exhud_coordinate_display,
@@ -212,6 +215,14 @@ exhud_component_t components_template[exhud_component_count] = {
     .strict = true,
     .off_by_default = true,
   },
+  [exhud_thinker_profile] = {
+    dsda_InitThinkerProfileHC,
+    dsda_UpdateThinkerProfileHC,
+    dsda_DrawThinkerProfileHC,
+    "thinker_profile",
+    .default_vpt = VPT_EX_TEXT,
+    .off_by_default = true,
+  },
   [exhud_fps] = {
     dsda_InitFPSHC,
     dsda_UpdateFPSHC,
@@ -220,6 +231,14 @@ exhud_component_t components_template[exhud_component_count] = {
     .default_vpt = VPT_EX_TEXT,
     .off_by_default = true,
   },
+  [exhud_frame_histogram] = {
+    dsda_InitFrameHistogramHC,
+    dsda_UpdateFrameHistogramHC,
+    dsda_DrawFrameHistogramHC,
+    "frame_histogram",
+    .default_vpt = VPT_EX_TEXT,
+    .off_by_default = true,
+  },
   [exhud_attempts] = {
     dsda_InitAttemptsHC,
     dsda_UpdateAttemptsHC,
@@ -622,6 +641,7 @@ static void dsda_RefreshHUD(void) {
     dsda_TurnComponentOn(exhud_render_stats);
 
   dsda_RefreshExHudFPS();
+  dsda_RefreshExHudThinkerProfile();
   dsda_RefreshExHudMinimap();
   dsda_RefreshExHudLevelSplits();
   dsda_RefreshExHudCoordinateDisplay();
@@ -726,6 +746,8 @@ void dsda_ToggleRenderStats(void) {
     dsda_BeginRenderStats();
     dsda_TurnComponentOn(exhud_render_stats);
   }
+
+  dsda_SetRenderStageTiming(components[exhud_render_stats].on);
 }
 
 static void dsda_BasicRefresh(dboolean (*show_component)(void), exhud_component_id_t id) {
@@ -759,6 +781,10 @@ void dsda_RefreshExHudFPS(void) {
   dsda_BasicRefresh(dsda_ShowFPS, exhud_fps);
 }
 
+void dsda_RefreshExHudThinkerProfile(void) {
+  dsda_BasicRefresh(dsda_ThinkerProfiling, exhud_thinker_profile);
+}
+
 void dsda_RefreshExHudMinimap(void) {
   if (!dsda_HUDActive())
     return;
@@ -0,0 +1,116 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Frame Stats
+//
+
+#include <stdio.h>
+
+#include "doomstat.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+
+#include "dsda/time.h"
+#include "dsda/utility.h"
+
+#include "frame_stats.h"
+
+// A frame is one D_Display call that draws, including any fps limiter sleep.
+// Uncapped frames are also drawn while waiting for tics, so the tics column
+//   counts the tics run since the previous frame (often 0).
+// The histogram has one millisecond bins, and the last bin collects
+//   everything at or above its value.
+
+#define FRAME_TIME_BINS 256
+
+static unsigned long long last_frame_time;
+static int last_gametic;
+static int frame_time_bins[FRAME_TIME_BINS];
+static int frame_time_total;
+static int frame_number;
+static FILE* frame_time_log;
+
+static void dsda_CloseFrameTimeLog(void) {
+  if (frame_time_log) {
+    fclose(frame_time_log);
+    frame_time_log = NULL;
+  }
+}
+
+void dsda_InitFrameTimeLog(const char* name) {
+  frame_time_log = M_OpenFile(name, "w");
+
+  if (!frame_time_log)
+    I_Error("dsda_InitFrameTimeLog: failed to open %s", name);
+
+  fprintf(frame_time_log, "frame,time_ms,tics\n");
+
+  I_AtExit(dsda_CloseFrameTimeLog, true, "dsda_CloseFrameTimeLog", exit_priority_normal);
+}
+
+void dsda_UpdateFrameStats(void) {
+  unsigned long long now;
+  unsigned long long elapsed;
+  int tics;
+  int bin;
+
+  now = dsda_TimeNS();
+
+  if (!last_frame_time) {
+    last_frame_time = now;
+    last_gametic = gametic;
+    return;
+  }
+
+  elapsed = now - last_frame_time;
+  tics = gametic - last_gametic;
+
+  last_frame_time = now;
+  last_gametic = gametic;
+
+  bin = elapsed / 1000000;
+  if (bin >= FRAME_TIME_BINS)
+    bin = FRAME_TIME_BINS - 1;
+
+  ++frame_time_bins[bin];
+  ++frame_time_total;
+
+  if (frame_time_log)
+    fprintf(frame_time_log, "%d,%.3f,%d\n", frame_number, elapsed / 1000000.0, tics);
+
+  ++frame_number;
+}
+
+void dsda_ResetFrameStats(void) {
+  ZERO_DATA(frame_time_bins);
+  frame_time_total = 0;
+}
+
+int dsda_FrameTimeCount(int min_ms, int max_ms) {
+  int i;
+  int count = 0;
+
+  if (max_ms < 0 || max_ms > FRAME_TIME_BINS)
+    max_ms = FRAME_TIME_BINS;
+
+  for (i = BETWEEN(0, FRAME_TIME_BINS, min_ms); i < max_ms; ++i)
+    count += frame_time_bins[i];
+
+  return count;
+}
+
+int dsda_FrameTimeTotal(void) {
+  return frame_time_total;
+}
@@ -0,0 +1,27 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Frame Stats
+//
+
+#ifndef __DSDA_FRAME_STATS__
+#define __DSDA_FRAME_STATS__
+
+void dsda_InitFrameTimeLog(const char* name);
+void dsda_UpdateFrameStats(void);
+void dsda_ResetFrameStats(void);
+int dsda_FrameTimeCount(int min_ms, int max_ms);
+int dsda_FrameTimeTotal(void);
+
+#endif
@@ -30,6 +30,7 @@
 #include "hud_components/coordinate_display.h"
 #include "hud_components/event_split.h"
 #include "hud_components/fps.h"
+#include "hud_components/frame_histogram.h"
 #include "hud_components/free_text.h"
 #include "hud_components/health_text.h"
 #include "hud_components/keys.h"
@@ -47,5 +48,6 @@
 #include "hud_components/secret_message.h"
 #include "hud_components/speed_text.h"
 #include "hud_components/stat_totals.h"
+#include "hud_components/thinker_profile.h"
 #include "hud_components/tracker.h"
 #include "hud_components/weapon_text.h"
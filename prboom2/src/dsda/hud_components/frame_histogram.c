@@ -0,0 +1,128 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Frame Histogram HUD Component
+//
+
+#include "dsda/frame_stats.h"
+
+#include "base.h"
+
+#include "frame_histogram.h"
+
+#define BAR_WIDTH 20
+
+static const int bucket_limits[] = { 4, 8, 12, 17, 25, 33, 50, 100, -1 };
+
+#define BUCKET_COUNT (sizeof(bucket_limits) / sizeof(bucket_limits[0]))
+
+typedef struct {
+  dsda_text_t component[BUCKET_COUNT + 1];
+  int threshold;
+} local_component_t;
+
+static local_component_t* local;
+
+static void dsda_UpdateComponentText(void) {
+  int i;
+  int counts[BUCKET_COUNT];
+  int max_count = 0;
+  int over;
+
+  over = dsda_FrameTimeCount(local->threshold, -1);
+
+  snprintf(
+    local->component[0].msg, sizeof(local->component[0].msg),
+    "%sFRAMES %s%d %sOVER %dMS %s%d",
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    dsda_TextColor(dsda_tc_exhud_render_good),
+    dsda_FrameTimeTotal(),
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    local->threshold,
+    over ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+           dsda_TextColor(dsda_tc_exhud_render_good),
+    over
+  );
+
+  for (i = 0; i < BUCKET_COUNT; ++i) {
+    counts[i] = dsda_FrameTimeCount(i ? bucket_limits[i - 1] : 0, bucket_limits[i]);
+
+    if (counts[i] > max_count)
+      max_count = counts[i];
+  }
+
+  for (i = 0; i < BUCKET_COUNT; ++i) {
+    char label[16];
+    char bar[BAR_WIDTH + 1];
+    int length;
+    int min_ms;
+
+    min_ms = i ? bucket_limits[i - 1] : 0;
+
+    if (bucket_limits[i] < 0)
+      snprintf(label, sizeof(label), "%d+", min_ms);
+    else
+      snprintf(label, sizeof(label), "%d-%d", min_ms, bucket_limits[i]);
+
+    length = max_count ? (counts[i] * BAR_WIDTH + max_count - 1) / max_count : 0;
+    memset(bar, '#', length);
+    bar[length] = '\0';
+
+    snprintf(
+      local->component[i + 1].msg, sizeof(local->component[i + 1].msg),
+      "%s%7s %s%-*s %d",
+      dsda_TextColor(dsda_tc_exhud_render_label),
+      label,
+      min_ms >= local->threshold ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                                   dsda_TextColor(dsda_tc_exhud_render_good),
+      BAR_WIDTH, bar,
+      counts[i]
+    );
+  }
+}
+
+void dsda_InitFrameHistogramHC(int x_offset, int y_offset, int vpt, int* args, int arg_count, void** data) {
+  int i;
+
+  *data = Z_Calloc(1, sizeof(local_component_t));
+  local = *data;
+
+  local->threshold = 50;
+
+  if (arg_count > 0 && args[0] > 0)
+    local->threshold = args[0];
+
+  for (i = 0; i <= BUCKET_COUNT; ++i)
+    dsda_InitTextHC(&local->component[i], x_offset, y_offset + i * 8, vpt);
+}
+
+void dsda_UpdateFrameHistogramHC(void* data) {
+  int i;
+
+  local = data;
+
+  dsda_UpdateComponentText();
+
+  for (i = 0; i <= BUCKET_COUNT; ++i)
+    dsda_RefreshHudText(&local->component[i]);
+}
+
+void dsda_DrawFrameHistogramHC(void* data) {
+  int i;
+
+  local = data;
+
+  for (i = 0; i <= BUCKET_COUNT; ++i)
+    dsda_DrawBasicText(&local->component[i]);
+}
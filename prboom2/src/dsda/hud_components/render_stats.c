@@ -21,8 +21,10 @@
 
 #include "render_stats.h"
 
+#define STAGE_LINE 2
+
 typedef struct {
-  dsda_text_t component[2];
+  dsda_text_t component[STAGE_LINE + DSDA_RENDER_STAGE_COUNT];
 } local_component_t;
 
 static local_component_t* local;
@@ -74,26 +76,73 @@ static void dsda_UpdateMaxComponentText(char* str, size_t max_size) {
   );
 }
 
+static void dsda_UpdateStageComponentText(void) {
+  extern dsda_render_stage_stats_t dsda_render_stage_stats[DSDA_RENDER_STAGE_COUNT];
+
+  int i;
+  int line = STAGE_LINE;
+
+  for (i = 0; i < DSDA_RENDER_STAGE_COUNT; ++i) {
+    dsda_render_stage_stats_t* stats = &dsda_render_stage_stats[i];
+
+    if (!stats->frames)
+      continue;
+
+    snprintf(
+      local->component[line].msg, sizeof(local->component[line].msg),
+      "%s%-6s %s%6.2f %sAVG %s%6.2f %sMAX %s%6.2f %sP99 %s%6.2f",
+      dsda_TextColor(dsda_tc_exhud_render_label),
+      dsda_RenderStageName(i),
+      dsda_TextColor(dsda_tc_exhud_render_good),
+      stats->current,
+      dsda_TextColor(dsda_tc_exhud_render_label),
+      dsda_TextColor(dsda_tc_exhud_render_good),
+      stats->average,
+      dsda_TextColor(dsda_tc_exhud_render_label),
+      stats->max > 1000.0 / 35 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                                 dsda_TextColor(dsda_tc_exhud_render_good),
+      stats->max,
+      dsda_TextColor(dsda_tc_exhud_render_label),
+      stats->p99 > 1000.0 / 35 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                                 dsda_TextColor(dsda_tc_exhud_render_good),
+      stats->p99
+    );
+
+    ++line;
+  }
+
+  for (; line < STAGE_LINE + DSDA_RENDER_STAGE_COUNT; ++line)
+    local->component[line].msg[0] = '\0';
+}
+
 void dsda_InitRenderStatsHC(int x_offset, int y_offset, int vpt, int* args, int arg_count, void** data) {
+  int i;
+
   *data = Z_Calloc(1, sizeof(local_component_t));
   local = *data;
 
-  dsda_InitTextHC(&local->component[0], x_offset, y_offset, vpt);
-  dsda_InitTextHC(&local->component[1], x_offset, y_offset + 8, vpt);
+  for (i = 0; i < STAGE_LINE + DSDA_RENDER_STAGE_COUNT; ++i)
+    dsda_InitTextHC(&local->component[i], x_offset, y_offset + i * 8, vpt);
 }
 
 void dsda_UpdateRenderStatsHC(void* data) {
+  int i;
+
   local = data;
 
   dsda_UpdateCurrentComponentText(local->component[0].msg, sizeof(local->component[0].msg));
   dsda_UpdateMaxComponentText(local->component[1].msg, sizeof(local->component[1].msg));
-  dsda_RefreshHudText(&local->component[0]);
-  dsda_RefreshHudText(&local->component[1]);
+  dsda_UpdateStageComponentText();
+
+  for (i = 0; i < STAGE_LINE + DSDA_RENDER_STAGE_COUNT; ++i)
+    dsda_RefreshHudText(&local->component[i]);
 }
 
 void dsda_DrawRenderStatsHC(void* data) {
+  int i;
+
   local = data;
 
-  dsda_DrawBasicText(&local->component[0]);
-  dsda_DrawBasicText(&local->component[1]);
+  for (i = 0; i < STAGE_LINE + DSDA_RENDER_STAGE_COUNT; ++i)
+    dsda_DrawBasicText(&local->component[i]);
 }
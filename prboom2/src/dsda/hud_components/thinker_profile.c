@@ -0,0 +1,100 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Thinker Profile HUD Component
+//
+
+#include "dsda/thinker_profile.h"
+
+#include "base.h"
+
+#include "thinker_profile.h"
+
+#define MAX_LINES 8
+
+typedef struct {
+  dsda_text_t component[MAX_LINES + 1];
+  int line_count;
+} local_component_t;
+
+static local_component_t* local;
+
+static void dsda_UpdateComponentText(void) {
+  int i, count;
+  double total;
+  dsda_profile_line_t lines[MAX_LINES];
+
+  total = dsda_ThinkerProfileRecentTotal();
+
+  snprintf(
+    local->component[0].msg, sizeof(local->component[0].msg),
+    "%sTHINKERS %s%7.3f MS",
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    total > 10 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
+                 dsda_TextColor(dsda_tc_exhud_render_good),
+    total
+  );
+
+  count = dsda_ThinkerProfileRecent(dsda_profile_thinkers, lines, local->line_count);
+
+  for (i = 0; i < local->line_count; ++i) {
+    if (i < count)
+      snprintf(
+        local->component[i + 1].msg, sizeof(local->component[i + 1].msg),
+        "%s%-24.24s %s%7.3f MS %5u",
+        dsda_TextColor(dsda_tc_exhud_render_label),
+        lines[i].name,
+        dsda_TextColor(dsda_tc_exhud_render_good),
+        lines[i].ms_per_tic,
+        lines[i].calls_per_tic
+      );
+    else
+      local->component[i + 1].msg[0] = '\0';
+  }
+}
+
+void dsda_InitThinkerProfileHC(int x_offset, int y_offset, int vpt, int* args, int arg_count, void** data) {
+  int i;
+
+  *data = Z_Calloc(1, sizeof(local_component_t));
+  local = *data;
+
+  local->line_count = 4;
+
+  if (arg_count > 0)
+    local->line_count = BETWEEN(0, MAX_LINES, args[0]);
+
+  for (i = 0; i <= local->line_count; ++i)
+    dsda_InitTextHC(&local->component[i], x_offset, y_offset + i * 8, vpt);
+}
+
+void dsda_UpdateThinkerProfileHC(void* data) {
+  int i;
+
+  local = data;
+
+  dsda_UpdateComponentText();
+
+  for (i = 0; i <= local->line_count; ++i)
+    dsda_RefreshHudText(&local->component[i]);
+}
+
+void dsda_DrawThinkerProfileHC(void* data) {
+  int i;
+
+  local = data;
+
+  for (i = 0; i <= local->line_count; ++i)
+    dsda_DrawBasicText(&local->component[i]);
+}
@@ -28,6 +28,7 @@ typedef struct {
 
 typedef struct {
   int size;
+  int allocated_size;
   id_list_t* lists;
 } id_index_t;
 
@@ -42,13 +43,19 @@ static id_hash_t sector_id_hash;
 static id_list_t* dsda_NewListForIndex(id_index_t* index, int id) {
   id_list_t* new_list;
 
-  index->lists = Z_ReallocLevel(index->lists, sizeof(*index->lists) * (index->size + 1));
+  if (index->allocated_size == index->size) {
+    int old_size = index->allocated_size;
+
+    index->allocated_size = old_size ? old_size * 2 : 1;
+    index->lists = Z_ArenaRealloc(index->lists, sizeof(*index->lists) * old_size,
+                                  sizeof(*index->lists) * index->allocated_size);
+  }
 
   new_list = &index->lists[index->size++];
   new_list->id = id;
   new_list->size = 0;
   new_list->allocated_size = 1;
-  new_list->data = Z_CallocLevel(new_list->allocated_size, sizeof(*new_list->data));
+  new_list->data = Z_ArenaMalloc(new_list->allocated_size * sizeof(*new_list->data));
   new_list->data[0] = -1;
 
   return new_list;
@@ -72,9 +79,12 @@ static void dsda_AddToIDHash(id_hash_t* hash, int id, int value) {
 
   list = dsda_GetIDList(hash, id);
   if (list->allocated_size < list->size + 2) {
+    int old_size = list->allocated_size;
+
     while (list->allocated_size < list->size + 2)
       list->allocated_size *= 2;
-    list->data = Z_ReallocLevel(list->data, list->allocated_size * sizeof(*list->data));
+    list->data = Z_ArenaRealloc(list->data, old_size * sizeof(*list->data),
+                                list->allocated_size * sizeof(*list->data));
   }
   list->data[list->size++] = value;
   list->data[list->size] = -1;
@@ -116,10 +126,10 @@ const int hash_factor = 10;
 
 void dsda_ResetLineIDList(int size) {
   line_id_hash.size = (size > hash_factor ? size / hash_factor : size);
-  line_id_hash.data = Z_CallocLevel(line_id_hash.size, sizeof(*line_id_hash.data));
+  line_id_hash.data = Z_ArenaCalloc(line_id_hash.size, sizeof(*line_id_hash.data));
 }
 
 void dsda_ResetSectorIDList(int size) {
   sector_id_hash.size = (size > hash_factor ? size / hash_factor : size);
-  sector_id_hash.data = Z_CallocLevel(sector_id_hash.size, sizeof(*sector_id_hash.data));
+  sector_id_hash.data = Z_ArenaCalloc(sector_id_hash.size, sizeof(*sector_id_hash.data));
 }
@@ -16,6 +16,7 @@
 //
 
 #include <time.h>
+#include <zlib.h>
 
 #include "doomstat.h"
 #include "s_advsound.h"
@@ -38,15 +39,19 @@
 #include "dsda/args.h"
 #include "dsda/build.h"
 #include "dsda/configuration.h"
+#include "dsda/delta.h"
 #include "dsda/demo.h"
 #include "dsda/features.h"
+#include "dsda/key_frame_export.h"
 #include "dsda/mapinfo.h"
 #include "dsda/options.h"
 #include "dsda/pause.h"
 #include "dsda/playback.h"
 #include "dsda/save.h"
 #include "dsda/settings.h"
+#include "dsda/state_hash.h"
 #include "dsda/time.h"
+#include "dsda/trace.h"
 
 #include "key_frame.h"
 
@@ -55,6 +60,12 @@ static int auto_kf_timeout_count;
 
 #define TIMEOUT_LIMIT 1
 
+// Auto key frames are stored as deltas against the previous one,
+//   with a full frame every AUTO_KF_FULL_INTERVAL frames.
+// A delta can only be restored while its whole chain is in the ring,
+//   so the ring has room for one extra chain.
+#define AUTO_KF_FULL_INTERVAL 16
+
 static dsda_key_frame_t first_kf;
 static dsda_key_frame_t quick_kf;
 static dsda_key_frame_t temp_kf;
@@ -63,9 +74,46 @@ static auto_kf_t* last_auto_kf;
 static int auto_kf_size;
 static int restore_key_frame_index = -1;
 
+// Full copy of the newest auto key frame, which the next delta is based on
+static dsda_key_frame_t auto_kf_base;
+static auto_kf_t* auto_kf_base_owner;
+static byte* auto_kf_base_owner_buffer;
+
+// Full frames that fall out of the ring are compressed and archived,
+//   then thinned out to stay within the memory budget
+typedef struct {
+  byte* buffer;
+  int buffer_length;
+  int full_length;
+  int game_tic_count;
+} archived_kf_t;
+
+static archived_kf_t* archived_kfs;
+static int archived_kf_count;
+static int archived_kf_capacity;
+static size_t archived_kf_bytes;
+static dsda_key_frame_t archived_kf;
+
+// Checkpoints make repeated backward steps in build mode cheap.
+// When a step has to simulate forward from an older key frame, snapshots
+//   are stored at sqrt spaced tics along the way, plus every tic in the
+//   last stretch before the target. The next step back restores one of
+//   those, and stepping past a sparse one repeats the process at a smaller
+//   scale. They stay valid until a command before them changes.
+#define CHECKPOINT_LIMIT 64
+
+static dsda_key_frame_t checkpoints[CHECKPOINT_LIMIT];
+static int checkpoint_count;
+static int checkpoint_base = -1;
+static int checkpoint_target = -1;
+static int checkpoint_stride;
+static int checkpoint_dense_start;
+static int checkpoint_dense_stride;
+
 static int dsda_auto_key_frame_interval;
 static int dsda_auto_key_frame_depth;
 static int dsda_auto_key_frame_timeout;
+static int dsda_auto_key_frame_budget;
 
 static int autoKeyFrameTimeout(void) {
   return dsda_StartInBuildMode() ? 0 : dsda_auto_key_frame_timeout;
@@ -78,6 +126,14 @@ static int autoKeyFrameDepth(void) {
   return dsda_auto_key_frame_depth;
 }
 
+static int autoKeyFrameBackupInterval(void) {
+  return dsda_Arg(dsda_arg_backup_auto_key_frames)->value.v_int;
+}
+
+static size_t autoKeyFrameBudget(void) {
+  return (size_t) dsda_auto_key_frame_budget * 1024 * 1024;
+}
+
 static int autoKeyFrameInterval(void) {
   if (dsda_StartInBuildMode())
     return 1;
@@ -89,11 +145,57 @@ static dboolean autoKFExists(auto_kf_t* auto_kf) {
   return auto_kf && auto_kf->auto_index && auto_kf->kf.buffer;
 }
 
-void dsda_ForgetAutoKeyFrames(void) {
+void dsda_ForgetCheckpointsAfter(int tic) {
+  int i, j;
+
+  for (i = 0, j = 0; i < checkpoint_count; ++i)
+    if (checkpoints[i].game_tic_count > tic) {
+      Z_Free(checkpoints[i].buffer);
+      checkpoints[i].buffer = NULL;
+    }
+    else
+      checkpoints[j++] = checkpoints[i];
+
+  checkpoint_count = j;
+
+  for (; j < CHECKPOINT_LIMIT; ++j)
+    checkpoints[j].buffer = NULL;
+
+  if (checkpoint_target > tic)
+    checkpoint_target = -1;
+}
+
+static void dsda_CutAutoKeyFrames(void) {
   if (last_auto_kf)
     last_auto_kf->auto_index = 0;
 }
 
+static void dsda_RemoveArchivedKF(int index) {
+  archived_kf_bytes -= archived_kfs[index].buffer_length;
+  Z_Free(archived_kfs[index].buffer);
+
+  --archived_kf_count;
+  memmove(&archived_kfs[index], &archived_kfs[index + 1],
+          (archived_kf_count - index) * sizeof(*archived_kfs));
+}
+
+// Drop archived frames from a timeline we have rewound out of
+static void dsda_TruncateArchivedKFs(int game_tic_count) {
+  while (archived_kf_count &&
+         archived_kfs[archived_kf_count - 1].game_tic_count > game_tic_count)
+    dsda_RemoveArchivedKF(archived_kf_count - 1);
+}
+
+static void dsda_ClearArchivedKFs(void) {
+  dsda_TruncateArchivedKFs(-1);
+}
+
+void dsda_ForgetAutoKeyFrames(void) {
+  dsda_CutAutoKeyFrames();
+  dsda_ClearArchivedKFs();
+  dsda_ForgetCheckpointsAfter(-1);
+}
+
 static void dsda_ResetParentKF(dsda_key_frame_t* kf) {
   kf->parent.auto_kf = NULL;
   kf->parent.buffer = NULL;
@@ -113,7 +215,202 @@ static void dsda_ResolveParentKF(dsda_key_frame_t* kf) {
     last_auto_kf = kf->parent.auto_kf;
   else {
     dsda_ResetParentKF(kf);
-    dsda_ForgetAutoKeyFrames();
+
+    // Archived frames are older than the whole ring, so only the ring is stale
+    if (kf == &archived_kf)
+      dsda_CutAutoKeyFrames();
+    else
+      dsda_ForgetAutoKeyFrames();
+  }
+}
+
+// Find the full frame at the start of the delta chain
+static auto_kf_t* dsda_AutoKFChainStart(auto_kf_t* auto_kf) {
+  int i;
+
+  for (i = auto_kf->delta_depth; i > 0; --i) {
+    if (!autoKFExists(auto_kf->prev) || auto_kf->prev->auto_index != auto_kf->auto_index - 1)
+      return NULL;
+
+    auto_kf = auto_kf->prev;
+  }
+
+  return auto_kf;
+}
+
+static dboolean dsda_AutoKFRestorable(auto_kf_t* auto_kf) {
+  return dsda_AutoKFChainStart(auto_kf) != NULL;
+}
+
+// Returns a full buffer for the auto key frame (caller frees it if it isn't kf.buffer)
+static byte* dsda_ExpandAutoKF(auto_kf_t* auto_kf, int* length) {
+  int i;
+  auto_kf_t* chain[AUTO_KF_FULL_INTERVAL];
+  auto_kf_t* current;
+  byte* buffer;
+  int buffer_length;
+
+  current = auto_kf;
+  for (i = auto_kf->delta_depth; i > 0; --i) {
+    chain[i - 1] = current;
+    current = current->prev;
+  }
+
+  buffer = current->kf.buffer;
+  buffer_length = current->kf.buffer_length;
+
+  for (i = 0; i < auto_kf->delta_depth; ++i) {
+    byte* next;
+
+    next = dsda_DecodeDelta(buffer, buffer_length,
+                            chain[i]->kf.buffer, chain[i]->kf.buffer_length, &buffer_length);
+
+    if (buffer != current->kf.buffer)
+      Z_Free(buffer);
+
+    buffer = next;
+  }
+
+  *length = buffer_length;
+
+  return buffer;
+}
+
+static void dsda_SetAutoKFBase(auto_kf_t* auto_kf, byte* buffer, int length) {
+  if (auto_kf_base.buffer)
+    Z_Free(auto_kf_base.buffer);
+
+  auto_kf_base.buffer = buffer;
+  auto_kf_base.buffer_length = length;
+  auto_kf_base_owner = auto_kf;
+  auto_kf_base_owner_buffer = auto_kf->kf.buffer;
+}
+
+static dboolean dsda_AutoKFBaseMatches(auto_kf_t* auto_kf) {
+  return auto_kf_base.buffer &&
+         auto_kf_base_owner == auto_kf &&
+         auto_kf_base_owner_buffer == auto_kf->kf.buffer;
+}
+
+// Replace the new full frame with a delta against the previous one
+static void dsda_CompressAutoKF(auto_kf_t* auto_kf) {
+  auto_kf_t* prev;
+  byte* full;
+  int full_length;
+
+  prev = auto_kf->prev;
+  full = auto_kf->kf.buffer;
+  full_length = auto_kf->kf.buffer_length;
+
+  auto_kf->delta_depth = 0;
+
+  if (
+    autoKFExists(prev) &&
+    prev->auto_index == auto_kf->auto_index - 1 &&
+    prev->delta_depth + 1 < AUTO_KF_FULL_INTERVAL &&
+    dsda_AutoKFBaseMatches(prev)
+  ) {
+    auto_kf->kf.buffer = dsda_EncodeDelta(auto_kf_base.buffer, auto_kf_base.buffer_length,
+                                          full, full_length, &auto_kf->kf.buffer_length);
+    auto_kf->delta_depth = prev->delta_depth + 1;
+
+    // The parent link identifies the frame by its buffer
+    dsda_AttachAutoKF(&auto_kf->kf);
+
+    dsda_SetAutoKFBase(auto_kf, full, full_length);
+  }
+  else {
+    byte* copy;
+
+    copy = Z_Malloc(full_length);
+    memcpy(copy, full, full_length);
+
+    dsda_SetAutoKFBase(auto_kf, copy, full_length);
+  }
+}
+
+static void dsda_ArchiveKF(dsda_key_frame_t* kf) {
+  archived_kf_t* archived;
+  uLongf length;
+  byte* buffer;
+
+  dsda_TruncateArchivedKFs(kf->game_tic_count - 1);
+
+  length = compressBound(kf->buffer_length);
+  buffer = Z_Malloc(length);
+
+  if (compress2(buffer, &length, kf->buffer, kf->buffer_length, Z_BEST_SPEED) != Z_OK) {
+    Z_Free(buffer);
+    return;
+  }
+
+  if (archived_kf_count == archived_kf_capacity) {
+    archived_kf_capacity = archived_kf_capacity ? archived_kf_capacity * 2 : 64;
+    archived_kfs = Z_Realloc(archived_kfs, archived_kf_capacity * sizeof(*archived_kfs));
+  }
+
+  archived = &archived_kfs[archived_kf_count++];
+  archived->buffer = Z_Realloc(buffer, length);
+  archived->buffer_length = length;
+  archived->full_length = kf->buffer_length;
+  archived->game_tic_count = kf->game_tic_count;
+
+  archived_kf_bytes += length;
+}
+
+// Evict the frame whose loss widens the gap around it the least relative
+//   to its age, which keeps recent history dense and older history sparse
+static void dsda_EvictArchivedKF(void) {
+  int i;
+  int best = 0;
+  long long best_gap = 0;
+  long long best_age = 1;
+
+  if (archived_kf_count <= 2) {
+    dsda_RemoveArchivedKF(0);
+    return;
+  }
+
+  for (i = 1; i < archived_kf_count - 1; ++i) {
+    long long gap, age;
+
+    gap = archived_kfs[i + 1].game_tic_count - archived_kfs[i - 1].game_tic_count;
+    age = true_logictic - archived_kfs[i].game_tic_count + 1;
+
+    if (!best || gap * best_age < best_gap * age) {
+      best = i;
+      best_gap = gap;
+      best_age = age;
+    }
+  }
+
+  dsda_RemoveArchivedKF(best);
+}
+
+static dsda_key_frame_t* dsda_ExpandArchivedKF(archived_kf_t* archived) {
+  uLongf length;
+
+  if (archived_kf.buffer)
+    Z_Free(archived_kf.buffer);
+
+  memset(&archived_kf, 0, sizeof(archived_kf));
+
+  length = archived->full_length;
+  archived_kf.buffer = Z_Malloc(length);
+
+  if (uncompress(archived_kf.buffer, &length, archived->buffer, archived->buffer_length) != Z_OK)
+    I_Error("dsda_ExpandArchivedKF: failed to decompress key frame");
+
+  archived_kf.buffer_length = length;
+  archived_kf.game_tic_count = archived->game_tic_count;
+
+  return &archived_kf;
+}
+
+static void dsda_ReleaseArchivedKF(void) {
+  if (archived_kf.buffer) {
+    Z_Free(archived_kf.buffer);
+    archived_kf.buffer = NULL;
   }
 }
 
@@ -130,9 +427,15 @@ static void dsda_RewindKF(auto_kf_t** current) {
     *current = NULL;
 }
 
-static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
+// An archived frame is returned through closest_archived without expanding it,
+//   since only the restore needs the contents
+static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count, auto_kf_t** closest_auto_kf,
+                                              archived_kf_t** closest_archived) {
   dsda_key_frame_t* closest = NULL;
 
+  *closest_auto_kf = NULL;
+  *closest_archived = NULL;
+
   if (last_auto_kf) {
     auto_kf_t* auto_kf;
 
@@ -140,7 +443,11 @@ static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
     for (auto_kf = last_auto_kf; auto_kf && auto_kf->kf.buffer; dsda_RewindKF(&auto_kf))
       if (auto_kf->kf.game_tic_count <= target_tic_count)
         if (!closest || auto_kf->kf.game_tic_count > closest->game_tic_count) {
-          closest = &auto_kf->kf;
+          if (dsda_AutoKFRestorable(auto_kf)) {
+            closest = &auto_kf->kf;
+            *closest_auto_kf = auto_kf;
+          }
+
           break;
         }
   }
@@ -160,6 +467,33 @@ static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
       if (!closest || first_kf.game_tic_count > closest->game_tic_count)
         closest = &first_kf;
 
+  // Checkpoints are tied to the demo buffer
+  if (demorecording) {
+    int i;
+
+    for (i = 0; i < checkpoint_count; ++i)
+      if (checkpoints[i].game_tic_count <= target_tic_count)
+        if (!closest || checkpoints[i].game_tic_count > closest->game_tic_count)
+          closest = &checkpoints[i];
+  }
+
+  {
+    int i;
+
+    for (i = archived_kf_count - 1; i >= 0; --i)
+      if (archived_kfs[i].game_tic_count <= target_tic_count) {
+        if (!closest || archived_kfs[i].game_tic_count > closest->game_tic_count) {
+          closest = NULL;
+          *closest_archived = &archived_kfs[i];
+        }
+
+        break;
+      }
+  }
+
+  if (*closest_auto_kf && closest != &(*closest_auto_kf)->kf)
+    *closest_auto_kf = NULL;
+
   return closest;
 }
 
@@ -175,6 +509,9 @@ void dsda_InitKeyFrame(void) {
   dsda_auto_key_frame_interval = dsda_IntConfig(dsda_config_auto_key_frame_interval);
   dsda_auto_key_frame_depth = dsda_IntConfig(dsda_config_auto_key_frame_depth);
   dsda_auto_key_frame_timeout = dsda_IntConfig(dsda_config_auto_key_frame_timeout);
+  dsda_auto_key_frame_budget = dsda_IntConfig(dsda_config_auto_key_frame_budget);
+
+  dsda_ClearArchivedKFs();
 
   auto_kf_size = autoKeyFrameDepth();
 
@@ -186,6 +523,7 @@ void dsda_InitKeyFrame(void) {
   if (auto_key_frames != NULL)
     Z_Free(auto_key_frames);
 
+  auto_kf_size += AUTO_KF_FULL_INTERVAL - 1; // room for the oldest delta chain
   ++auto_kf_size; // chain includes a terminator
 
   auto_key_frames = Z_Calloc(auto_kf_size, sizeof(auto_kf_t));
@@ -202,6 +540,8 @@ void dsda_InitKeyFrame(void) {
   last_auto_kf = &auto_key_frames[auto_kf_size - 1];
 }
 
+static char last_export_name[40];
+
 void dsda_ExportKeyFrame(byte* buffer, int length) {
   char name[40];
   int timestamp;
@@ -210,15 +550,18 @@ void dsda_ExportKeyFrame(byte* buffer, int length) {
 
   snprintf(name, sizeof(name), "backup-%010d.kf", timestamp);
 
-  if (M_FileExists(name))
+  if (M_FileExists(name) || !strcmp(name, last_export_name))
     snprintf(name, sizeof(name), "backup-%010d-%lld.kf", timestamp, (long long) time(NULL));
 
-  if (!M_WriteFile(name, buffer, length))
-    I_Error("dsda_ExportKeyFrame: Failed to write key frame.");
+  strcpy(last_export_name, name);
+
+  dsda_QueueKeyFrameExport(name, buffer, length);
 }
 
 // Stripped down version of G_DoSaveGame
-void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export) {
+static void dsda_SerializeKeyFrame(dsda_key_frame_t* key_frame, byte complete) {
+  DSDA_TRACE_BEGIN("key_frame");
+
   key_frame->game_tic_count = true_logictic;
 
   P_InitSaveBuffer();
@@ -232,6 +575,8 @@ void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export)
   // Store state of demo recording buffer
   dsda_StoreDemoData(complete);
 
+  key_frame->archive_offset = save_p - savebuffer;
+
   dsda_ArchiveAll();
 
   if (key_frame->buffer != NULL) Z_Free(key_frame->buffer);
@@ -241,6 +586,28 @@ void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export)
 
   P_ForgetSaveBuffer();
 
+  DSDA_TRACE_END("key_frame");
+}
+
+// Identity of the game state in a key frame, leaving out the demo buffers
+uint64_t dsda_KeyFrameStateHash(const dsda_key_frame_t* key_frame) {
+  return dsda_HashArchive(key_frame->buffer + key_frame->archive_offset,
+                          key_frame->buffer_length - key_frame->archive_offset);
+}
+
+dboolean dsda_KeyFrameStatesEqual(const dsda_key_frame_t* a, const dsda_key_frame_t* b) {
+  int length_a, length_b;
+
+  length_a = dsda_ArchiveStateLength(a->buffer_length - a->archive_offset);
+  length_b = dsda_ArchiveStateLength(b->buffer_length - b->archive_offset);
+
+  return length_a == length_b &&
+         !memcmp(a->buffer + a->archive_offset, b->buffer + b->archive_offset, length_a);
+}
+
+void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export) {
+  dsda_SerializeKeyFrame(key_frame, complete);
+
   dsda_AttachAutoKF(key_frame);
 
   if (complete) {
@@ -290,6 +657,8 @@ void dsda_RestoreKeyFrame(dsda_key_frame_t* key_frame, dboolean skip_wipe) {
 
   dsda_ResolveParentKF(key_frame);
 
+  dsda_TruncateArchivedKFs(key_frame->game_tic_count);
+
   doom_printf("Restored key frame");
 }
 
@@ -305,15 +674,42 @@ void dsda_RestoreQuickKeyFrame(void) {
   dsda_RestoreKeyFrame(&quick_kf, false);
 }
 
+static void dsda_RestoreAutoKeyFrame(auto_kf_t* auto_kf) {
+  dsda_key_frame_t key_frame;
+
+  if (!auto_kf->delta_depth) {
+    dsda_RestoreKeyFrame(&auto_kf->kf, true);
+    return;
+  }
+
+  key_frame = auto_kf->kf;
+  key_frame.buffer = dsda_ExpandAutoKF(auto_kf, &key_frame.buffer_length);
+
+  dsda_RestoreKeyFrame(&key_frame, true);
+
+  // The next auto key frame will be a delta against this one
+  dsda_SetAutoKFBase(auto_kf, key_frame.buffer, key_frame.buffer_length);
+}
+
 dboolean dsda_RestoreClosestKeyFrame(int tic) {
   dsda_key_frame_t* key_frame;
+  auto_kf_t* auto_kf;
+  archived_kf_t* archived;
 
-  key_frame = dsda_ClosestKeyFrame(tic);
+  key_frame = dsda_ClosestKeyFrame(tic, &auto_kf, &archived);
+
+  if (archived)
+    key_frame = dsda_ExpandArchivedKF(archived);
 
   if (!key_frame)
     return false;
 
-  dsda_RestoreKeyFrame(key_frame, true);
+  if (auto_kf)
+    dsda_RestoreAutoKeyFrame(auto_kf);
+  else
+    dsda_RestoreKeyFrame(key_frame, true);
+
+  dsda_ReleaseArchivedKF();
 
   return true;
 }
@@ -322,10 +718,15 @@ void dsda_RestoreKeyFrameFile(const char* name) {
   char *filename;
   dsda_key_frame_t key_frame = { 0 };
 
+  // The file may still be on its way to the disk
+  dsda_FlushKeyFrameExports();
+
   filename = I_RequireFile(name, ".kf");
-  M_ReadFile(filename, &key_frame.buffer);
+  key_frame.buffer_length = M_ReadFile(filename, &key_frame.buffer);
   Z_Free(filename);
 
+  dsda_ExpandKeyFrameFile(&key_frame.buffer, &key_frame.buffer_length);
+
   dsda_RestoreKeyFrame(&key_frame, false);
   Z_Free(key_frame.buffer);
 }
@@ -339,18 +740,150 @@ void dsda_ContinueKeyFrame(void) {
   }
 }
 
+int dsda_ClosestKeyFrameTic(int tic) {
+  dsda_key_frame_t* key_frame;
+  auto_kf_t* auto_kf;
+  archived_kf_t* archived;
+
+  key_frame = dsda_ClosestKeyFrame(tic, &auto_kf, &archived);
+
+  if (archived)
+    return archived->game_tic_count;
+
+  return key_frame ? key_frame->game_tic_count : -1;
+}
+
+void dsda_PlanCheckpoints(int target) {
+  int base;
+  int distance;
+  int dense_count;
+
+  checkpoint_target = -1;
+
+  if (!demorecording)
+    return;
+
+  // Snapshots past the target belong to steps we have already taken
+  dsda_ForgetCheckpointsAfter(target);
+
+  base = dsda_ClosestKeyFrameTic(target);
+  distance = target - base;
+
+  if (base < 0 || distance < 2)
+    return;
+
+  checkpoint_stride = 1;
+  while (checkpoint_stride * checkpoint_stride < distance)
+    ++checkpoint_stride;
+
+  if (checkpoint_stride < distance / (CHECKPOINT_LIMIT / 2))
+    checkpoint_stride = (distance + CHECKPOINT_LIMIT / 2 - 1) / (CHECKPOINT_LIMIT / 2);
+
+  checkpoint_dense_start = base + (distance - 1) / checkpoint_stride * checkpoint_stride + 1;
+  dense_count = target - checkpoint_dense_start + 1;
+  checkpoint_dense_stride = (dense_count + CHECKPOINT_LIMIT / 2 - 1) / (CHECKPOINT_LIMIT / 2);
+
+  checkpoint_base = base;
+  checkpoint_target = target;
+}
+
+void dsda_UpdateCheckpoints(void) {
+  int tic;
+
+  tic = true_logictic;
+
+  if (checkpoint_target < 0 || tic <= checkpoint_base || !demorecording)
+    return;
+
+  if (tic > checkpoint_target) {
+    checkpoint_target = -1;
+    return;
+  }
+
+  if (tic < checkpoint_dense_start) {
+    if ((tic - checkpoint_base) % checkpoint_stride)
+      return;
+  }
+  else if ((tic - checkpoint_dense_start) % checkpoint_dense_stride)
+    return;
+
+  if (checkpoint_count == CHECKPOINT_LIMIT)
+    return;
+
+  dsda_StoreKeyFrame(&checkpoints[checkpoint_count++], false, false);
+}
+
 void dsda_RewindAutoKeyFrame(void) {
   auto_kf_t* load_kf;
 
   load_kf = last_auto_kf;
   dsda_RewindKF(&load_kf);
 
-  if (load_kf)
-    dsda_RestoreKeyFrame(&load_kf->kf, true);
+  if (load_kf && dsda_AutoKFRestorable(load_kf))
+    dsda_RestoreAutoKeyFrame(load_kf);
   else
     doom_printf("No key frame found"); // rewind past the depth limit
 }
 
+static size_t dsda_AutoKFMemory(void) {
+  size_t total;
+  auto_kf_t* auto_kf;
+
+  total = archived_kf_bytes + auto_kf_base.buffer_length;
+
+  for (auto_kf = last_auto_kf; autoKFExists(auto_kf); dsda_RewindKF(&auto_kf))
+    total += auto_kf->kf.buffer_length;
+
+  return total;
+}
+
+static void dsda_DropAutoKF(auto_kf_t* auto_kf) {
+  Z_Free(auto_kf->kf.buffer);
+  auto_kf->kf.buffer = NULL;
+  auto_kf->auto_index = 0;
+}
+
+// Thin out the archive first, then shorten the ring from the oldest end,
+//   but always keep the chain needed to restore the newest frame
+static void dsda_EnforceAutoKFBudget(void) {
+  size_t budget;
+  size_t memory;
+
+  budget = autoKeyFrameBudget();
+  memory = dsda_AutoKFMemory();
+
+  while (memory > budget && archived_kf_count) {
+    dsda_EvictArchivedKF();
+    memory = dsda_AutoKFMemory();
+  }
+
+  while (memory > budget) {
+    auto_kf_t* oldest;
+    auto_kf_t* newest_start;
+
+    oldest = last_auto_kf;
+    for (dsda_RewindKF(&oldest); oldest; dsda_RewindKF(&oldest))
+      if (!autoKFExists(oldest->prev) || oldest->prev->auto_index != oldest->auto_index - 1)
+        break;
+
+    newest_start = dsda_AutoKFChainStart(last_auto_kf);
+
+    if (!oldest || oldest == newest_start)
+      break;
+
+    // The frames after it depend on it until the next full frame
+    do {
+      auto_kf_t* next;
+
+      next = oldest->next;
+      dsda_DropAutoKF(oldest);
+      oldest = next;
+    } while (oldest != newest_start && oldest != last_auto_kf && oldest->delta_depth);
+
+    memory = dsda_AutoKFMemory();
+  }
+}
+
 void dsda_ResetAutoKeyFrameTimeout(void) {
   auto_kf_timed_out = false;
   auto_kf_timeout_count = 0;
@@ -383,33 +916,53 @@ void dsda_UpdateAutoKeyFrames(void) {
     }
 
     last_auto_kf = last_auto_kf->next;
-    last_auto_kf->next->auto_index = 0;
     last_auto_kf->auto_index = last_auto_kf->prev->auto_index + 1;
 
+    // The oldest frame falls out of the ring
+    if (
+      autoKeyFrameBudget() &&
+      autoKFExists(last_auto_kf->next) &&
+      !last_auto_kf->next->delta_depth &&
+      last_auto_kf->next->auto_index == last_auto_kf->auto_index - (auto_kf_size - 1)
+    ) dsda_ArchiveKF(&last_auto_kf->next->kf);
+
+    last_auto_kf->next->auto_index = 0;
+
     current_key_frame = &last_auto_kf->kf;
 
-    {
-      unsigned long long elapsed_time;
+    // Compression and the budget are part of the cost of a key frame
+    dsda_StartTimer(dsda_timer_key_frame);
+    dsda_StoreKeyFrame(current_key_frame, false, false);
 
-      dsda_StartTimer(dsda_timer_key_frame);
-      dsda_StoreKeyFrame(current_key_frame, false, false);
-      elapsed_time = dsda_ElapsedTimeMS(dsda_timer_key_frame);
+    if (!first_kf.buffer)
+      dsda_CopyKeyFrame(&first_kf, current_key_frame);
 
-      if (autoKeyFrameTimeout()) {
-        if (elapsed_time > autoKeyFrameTimeout()) {
-          ++auto_kf_timeout_count;
+    // Recovery points need the demo buffer, so they are serialized separately
+    if (demorecording && autoKeyFrameBackupInterval() &&
+        key_frame_index % autoKeyFrameBackupInterval() == 0) {
+      dsda_key_frame_t backup_kf = { 0 };
 
-          if (auto_kf_timeout_count > TIMEOUT_LIMIT) {
-            auto_kf_timed_out = true;
-            doom_printf("Slow key framing: rewind disabled");
-          }
+      dsda_SerializeKeyFrame(&backup_kf, true);
+      dsda_QueueKeyFrameExport("backup-auto.kf", backup_kf.buffer, backup_kf.buffer_length);
+      Z_Free(backup_kf.buffer);
+    }
+
+    dsda_CompressAutoKF(last_auto_kf);
+
+    if (autoKeyFrameBudget())
+      dsda_EnforceAutoKFBudget();
+
+    if (autoKeyFrameTimeout()) {
+      if (dsda_ElapsedTimeMS(dsda_timer_key_frame) > autoKeyFrameTimeout()) {
+        ++auto_kf_timeout_count;
+
+        if (auto_kf_timeout_count > TIMEOUT_LIMIT) {
+          auto_kf_timed_out = true;
+          doom_printf("Slow key framing: rewind disabled");
         }
-        else
-          auto_kf_timeout_count = 0;
       }
+      else
+        auto_kf_timeout_count = 0;
     }
-
-    if (!first_kf.buffer)
-      dsda_CopyKeyFrame(&first_kf, current_key_frame);
   }
 }
@@ -30,12 +30,14 @@ typedef struct {
 typedef struct {
   byte* buffer;
   int buffer_length;
+  int archive_offset; // start of the dsda_ArchiveAll data, 0 if unknown
   int game_tic_count;
   parent_kf_t parent;
 } dsda_key_frame_t;
 
 typedef struct auto_kf_s {
   int auto_index;
+  int delta_depth;
   dsda_key_frame_t kf;
   struct auto_kf_s* prev;
   struct auto_kf_s* next;
@@ -50,9 +52,15 @@ void dsda_StoreTempKeyFrame(void);
 void dsda_StoreQuickKeyFrame(void);
 void dsda_RestoreQuickKeyFrame(void);
 dboolean dsda_RestoreClosestKeyFrame(int tic);
+int dsda_ClosestKeyFrameTic(int tic);
+void dsda_ForgetCheckpointsAfter(int tic);
+void dsda_PlanCheckpoints(int target);
+void dsda_UpdateCheckpoints(void);
 void dsda_RewindAutoKeyFrame(void);
 void dsda_ResetAutoKeyFrameTimeout(void);
 void dsda_UpdateAutoKeyFrames(void);
 void dsda_ForgetAutoKeyFrames(void);
+uint64_t dsda_KeyFrameStateHash(const dsda_key_frame_t* key_frame);
+dboolean dsda_KeyFrameStatesEqual(const dsda_key_frame_t* a, const dsda_key_frame_t* b);
 
 #endif
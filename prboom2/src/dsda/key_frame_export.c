@@ -0,0 +1,380 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Key Frame Export
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include "SDL.h"
+
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "z_zone.h"
+
+#include "key_frame_export.h"
+
+// Key frame files are compressed and written by a background thread so the
+//   game never waits on them. The zone allocator is not thread safe, so
+//   everything the thread touches uses malloc, and the names are converted
+//   to the native form on the game thread.
+// Each file is written under a temporary name first and then replaces the
+//   old file in one step, so a crash leaves either the old or the new key
+//   frame, never a torn or missing one.
+
+// Compressed files start with the magic and the uncompressed length (LE).
+// Uncompressed files start with the "complete" byte, which is 0 or 1.
+static const byte kf_export_magic[4] = { 'D', 'S', 'K', 'F' };
+
+#define KF_EXPORT_HEADER_SIZE 8
+
+#ifdef _WIN32
+typedef wchar_t kf_export_path_t;
+#else
+typedef char kf_export_path_t;
+#endif
+
+typedef struct kf_export_job_s {
+  char* name;
+  kf_export_path_t* path;
+  kf_export_path_t* temp_path;
+  byte* buffer;
+  int length;
+  dboolean result;
+  struct kf_export_job_s* next;
+} kf_export_job_t;
+
+typedef struct {
+  kf_export_job_t* head;
+  kf_export_job_t* tail;
+} kf_export_queue_t;
+
+static SDL_Thread* kf_export_thread;
+static SDL_mutex* kf_export_mutex;
+static SDL_cond* kf_export_cond;
+static kf_export_queue_t kf_export_todo;
+static kf_export_queue_t kf_export_done;
+static int kf_export_pending;
+static dboolean kf_export_quit;
+
+static void dsda_PushKeyFrameExport(kf_export_queue_t* queue, kf_export_job_t* job) {
+  job->next = NULL;
+
+  if (queue->tail)
+    queue->tail->next = job;
+  else
+    queue->head = job;
+
+  queue->tail = job;
+}
+
+// Called on the game thread, where the zone is available
+static kf_export_path_t* dsda_KeyFrameExportPath(const char* name) {
+#ifdef _WIN32
+  wchar_t* wname;
+  wchar_t* result;
+
+  wname = ConvertUtf8ToWide(name);
+
+  if (!wname)
+    return NULL;
+
+  result = malloc((wcslen(wname) + 1) * sizeof(*result));
+
+  if (result)
+    wcscpy(result, wname);
+
+  Z_Free(wname);
+
+  return result;
+#else
+  return strdup(name);
+#endif
+}
+
+static FILE* dsda_OpenKeyFrameExport(const kf_export_path_t* path) {
+#ifdef _WIN32
+  return _wfopen(path, L"wb");
+#else
+  return fopen(path, "wb");
+#endif
+}
+
+static void dsda_RemoveKeyFrameExport(const kf_export_path_t* path) {
+#ifdef _WIN32
+  _wremove(path);
+#else
+  remove(path);
+#endif
+}
+
+// Replaces the old file atomically
+static dboolean dsda_ReplaceKeyFrameExport(const kf_export_path_t* temp_path,
+                                           const kf_export_path_t* path) {
+#ifdef _WIN32
+  return MoveFileExW(temp_path, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  return !rename(temp_path, path);
+#endif
+}
+
+// Closes the file in any case
+static dboolean dsda_WriteCompressedKeyFrame(kf_export_job_t* job, FILE* fstream) {
+  uLongf length;
+  byte* compressed;
+  dboolean result;
+
+  length = compressBound(job->length);
+  compressed = malloc(KF_EXPORT_HEADER_SIZE + length);
+
+  if (!compressed) {
+    fclose(fstream);
+    return false;
+  }
+
+  memcpy(compressed, kf_export_magic, sizeof(kf_export_magic));
+  compressed[4] = job->length & 0xff;
+  compressed[5] = (job->length >> 8) & 0xff;
+  compressed[6] = (job->length >> 16) & 0xff;
+  compressed[7] = (job->length >> 24) & 0xff;
+
+  if (compress2(compressed + KF_EXPORT_HEADER_SIZE, &length,
+                job->buffer, job->length, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    fclose(fstream);
+    free(compressed);
+    return false;
+  }
+
+  result = fwrite(compressed, KF_EXPORT_HEADER_SIZE + length, 1, fstream) == 1;
+  result = !fclose(fstream) && result;
+
+  free(compressed);
+
+  return result;
+}
+
+static dboolean dsda_ExportKeyFrameJob(kf_export_job_t* job) {
+  FILE* fstream;
+
+  fstream = dsda_OpenKeyFrameExport(job->temp_path);
+
+  if (!fstream)
+    return false;
+
+  if (dsda_WriteCompressedKeyFrame(job, fstream) &&
+      dsda_ReplaceKeyFrameExport(job->temp_path, job->path))
+    return true;
+
+  dsda_RemoveKeyFrameExport(job->temp_path);
+
+  return false;
+}
+
+static int dsda_KeyFrameExportThread(void* data) {
+  while (1) {
+    kf_export_job_t* job;
+
+    SDL_LockMutex(kf_export_mutex);
+
+    while (!kf_export_todo.head && !kf_export_quit)
+      SDL_CondWait(kf_export_cond, kf_export_mutex);
+
+    job = kf_export_todo.head;
+
+    if (job) {
+      kf_export_todo.head = job->next;
+      if (!kf_export_todo.head)
+        kf_export_todo.tail = NULL;
+    }
+
+    SDL_UnlockMutex(kf_export_mutex);
+
+    if (!job)
+      break;
+
+    job->result = dsda_ExportKeyFrameJob(job);
+
+    free(job->buffer);
+    job->buffer = NULL;
+
+    SDL_LockMutex(kf_export_mutex);
+
+    dsda_PushKeyFrameExport(&kf_export_done, job);
+
+    --kf_export_pending;
+    SDL_CondBroadcast(kf_export_cond);
+
+    SDL_UnlockMutex(kf_export_mutex);
+  }
+
+  return 0;
+}
+
+// Collects the finished jobs, returns the first that failed (to be freed)
+static char* dsda_FinishKeyFrameExports(void) {
+  kf_export_job_t* job;
+  char* failed = NULL;
+
+  SDL_LockMutex(kf_export_mutex);
+  job = kf_export_done.head;
+  kf_export_done.head = NULL;
+  kf_export_done.tail = NULL;
+  SDL_UnlockMutex(kf_export_mutex);
+
+  while (job) {
+    kf_export_job_t* next;
+
+    if (!job->result && !failed)
+      failed = strdup(job->name);
+
+    next = job->next;
+
+    free(job->name);
+    free(job->path);
+    free(job->temp_path);
+    free(job);
+
+    job = next;
+  }
+
+  return failed;
+}
+
+static void dsda_CheckKeyFrameExport(void) {
+  char* failed;
+
+  failed = dsda_FinishKeyFrameExports();
+
+  if (failed)
+    I_Error("dsda_ExportKeyFrame: Failed to write key frame %s.", failed);
+}
+
+static void dsda_ShutdownKeyFrameExport(void) {
+  char* failed;
+
+  SDL_LockMutex(kf_export_mutex);
+  kf_export_quit = true;
+  SDL_CondBroadcast(kf_export_cond);
+  SDL_UnlockMutex(kf_export_mutex);
+
+  // The queue is drained before the thread exits
+  SDL_WaitThread(kf_export_thread, NULL);
+  kf_export_thread = NULL;
+
+  failed = dsda_FinishKeyFrameExports();
+
+  if (failed) {
+    lprintf(LO_ERROR, "dsda_ExportKeyFrame: Failed to write key frame %s.\n", failed);
+    free(failed);
+  }
+}
+
+static void dsda_InitKeyFrameExport(void) {
+  kf_export_mutex = SDL_CreateMutex();
+  kf_export_cond = SDL_CreateCond();
+  kf_export_thread = SDL_CreateThread(dsda_KeyFrameExportThread, "kf_export", NULL);
+
+  if (!kf_export_mutex || !kf_export_cond || !kf_export_thread)
+    I_Error("dsda_InitKeyFrameExport: failed to start the export thread");
+
+  I_AtExit(dsda_ShutdownKeyFrameExport, true, "dsda_ShutdownKeyFrameExport", exit_priority_normal);
+}
+
+void dsda_QueueKeyFrameExport(const char* name, const byte* buffer, int length) {
+  kf_export_job_t* job;
+  char* temp_name;
+
+  if (!kf_export_thread) {
+    if (kf_export_quit)
+      return;
+
+    dsda_InitKeyFrameExport();
+  }
+
+  dsda_CheckKeyFrameExport();
+
+  job = calloc(1, sizeof(*job));
+  if (!job)
+    I_Error("dsda_QueueKeyFrameExport: out of memory");
+
+  temp_name = Z_Malloc(strlen(name) + 5);
+  sprintf(temp_name, "%s.tmp", name);
+
+  job->name = strdup(name);
+  job->path = dsda_KeyFrameExportPath(name);
+  job->temp_path = dsda_KeyFrameExportPath(temp_name);
+  job->buffer = malloc(length);
+  job->length = length;
+
+  Z_Free(temp_name);
+
+  if (!job->name || !job->path || !job->temp_path || !job->buffer)
+    I_Error("dsda_QueueKeyFrameExport: out of memory");
+
+  memcpy(job->buffer, buffer, length);
+
+  SDL_LockMutex(kf_export_mutex);
+
+  dsda_PushKeyFrameExport(&kf_export_todo, job);
+  ++kf_export_pending;
+
+  SDL_CondSignal(kf_export_cond);
+  SDL_UnlockMutex(kf_export_mutex);
+}
+
+// Wait for pending files, e.g. before reading one back
+void dsda_FlushKeyFrameExports(void) {
+  if (!kf_export_thread)
+    return;
+
+  SDL_LockMutex(kf_export_mutex);
+
+  while (kf_export_pending)
+    SDL_CondWait(kf_export_cond, kf_export_mutex);
+
+  SDL_UnlockMutex(kf_export_mutex);
+
+  dsda_CheckKeyFrameExport();
+}
+
+void dsda_ExpandKeyFrameFile(byte** buffer, int* length) {
+  uLongf full_length;
+  byte* full;
+  const byte* header;
+
+  header = *buffer;
+
+  if (*length < KF_EXPORT_HEADER_SIZE || memcmp(header, kf_export_magic, sizeof(kf_export_magic)))
+    return;
+
+  full_length = header[4] | (header[5] << 8) | (header[6] << 16) | ((unsigned int) header[7] << 24);
+  full = Z_Malloc(full_length);
+
+  if (uncompress(full, &full_length, header + KF_EXPORT_HEADER_SIZE,
+                 *length - KF_EXPORT_HEADER_SIZE) != Z_OK)
+    I_Error("dsda_ExpandKeyFrameFile: corrupt key frame file");
+
+  Z_Free(*buffer);
+  *buffer = full;
+  *length = full_length;
+}
@@ -0,0 +1,27 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Key Frame Export
+//
+
+#ifndef __DSDA_KEY_FRAME_EXPORT__
+#define __DSDA_KEY_FRAME_EXPORT__
+
+#include "doomtype.h"
+
+void dsda_QueueKeyFrameExport(const char* name, const byte* buffer, int length);
+void dsda_FlushKeyFrameExports(void);
+void dsda_ExpandKeyFrameFile(byte** buffer, int* length);
+
+#endif
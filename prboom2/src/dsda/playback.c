@@ -15,19 +15,37 @@
 //	DSDA Playback
 //
 
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+#include "d_main.h"
+#include "d_net.h"
 #include "doomstat.h"
+#include "e6y.h"
 #include "g_game.h"
+#include "i_main.h"
 #include "i_system.h"
 #include "lprintf.h"
+#include "m_file.h"
+#include "m_misc.h"
 #include "p_saveg.h"
 #include "w_wad.h"
 
+#include "dsda/analysis.h"
 #include "dsda/args.h"
+#include "dsda/benchmark.h"
 #include "dsda/demo.h"
 #include "dsda/exdemo.h"
 #include "dsda/input.h"
 #include "dsda/key_frame.h"
+#include "dsda/seek_index.h"
 #include "dsda/skip.h"
+#include "dsda/utility.h"
 
 #include "playback.h"
 
@@ -42,9 +60,16 @@ static dsda_arg_t* playlump_arg;
 static dsda_arg_t* fastdemo_arg;
 static dsda_arg_t* timedemo_arg;
 static dsda_arg_t* recordfromto_arg;
+static dsda_arg_t* playdemolist_arg;
 static char* playback_name;
 static char* playback_filename;
 
+static char* playback_list_buffer;
+static char** playback_list;
+static int playback_list_count;
+static int playback_list_index;
+static FILE* playback_list_results;
+
 dboolean demoplayback;
 dboolean userdemo;
 
@@ -53,14 +78,24 @@ void dsda_RestartPlayback(void) {
 }
 
 dboolean dsda_JumpToLogicTic(int tic) {
+  int index_tic;
+
   if (tic < 0)
     return false;
 
-  if (tic > true_logictic)
-    dsda_SkipToLogicTic(tic);
+  index_tic = dsda_SeekIndexTic(tic);
+
+  if (tic > true_logictic) {
+    if (index_tic > true_logictic)
+      dsda_RestoreSeekIndex(tic);
+
+    if (tic != true_logictic)
+      dsda_SkipToLogicTic(tic);
+  }
   else if (tic < true_logictic) {
-    if (!dsda_RestoreClosestKeyFrame(tic))
-      return false;
+    if (index_tic < 0 || index_tic <= dsda_ClosestKeyFrameTic(tic) || !dsda_RestoreSeekIndex(tic))
+      if (!dsda_RestoreClosestKeyFrame(tic))
+        return false;
 
     if (tic != true_logictic)
       dsda_SkipToLogicTic(tic);
@@ -86,38 +121,6 @@ const char* dsda_PlaybackName(void) {
   return playback_name;
 }
 
-void dsda_ExecutePlaybackOptions(void) {
-  if (playdemo_arg)
-  {
-    G_DeferedPlayDemo(playback_name);
-    userdemo = true;
-  }
-  else if (playlump_arg) {
-    if (W_CheckNumForName(playback_name) == LUMP_NOT_FOUND)
-      I_Error("Unable to find required internal demo lump \"%s\"", playback_name);
-
-    G_DeferedPlayDemo(playback_name);
-    userdemo = true;
-  }
-  else if (fastdemo_arg) {
-    G_DeferedPlayDemo(playback_name);
-    fastdemo = true;
-    timingdemo = true;
-    userdemo = true;
-  }
-  else if (timedemo_arg)
-  {
-    G_DeferedPlayDemo(playback_name);
-    singletics = true;
-    timingdemo = true;
-    userdemo = true;
-  }
-  else if (recordfromto_arg) {
-    userdemo = true;
-    G_ContinueDemo(playback_name);
-  }
-}
-
 static void dsda_UpdatePlaybackName(const char* name, dboolean require_file) {
   if (playback_name)
     Z_Free(playback_name);
@@ -133,6 +136,53 @@ static void dsda_UpdatePlaybackName(const char* name, dboolean require_file) {
     playback_filename = NULL;
 }
 
+static void dsda_LoadPlaybackList(dsda_arg_t* arg) {
+  int i, count;
+  const char* results_name;
+
+  if (M_ReadFileToString(arg->value.v_string_array[0], &playback_list_buffer) == -1)
+    I_Error("Unable to read demo list %s", arg->value.v_string_array[0]);
+
+  playback_list = dsda_SplitString(playback_list_buffer, "\n\r");
+
+  for (i = 0, count = 0; playback_list[i]; ++i) {
+    M_StrRTrim(playback_list[i]);
+
+    if (playback_list[i][0] && playback_list[i][0] != '#')
+      playback_list[count++] = playback_list[i];
+  }
+
+  playback_list[count] = NULL;
+  playback_list_count = count;
+
+  if (!count)
+    I_Error("Demo list %s is empty", arg->value.v_string_array[0]);
+
+  results_name = arg->count > 1 ? arg->value.v_string_array[1] : "demoresults.txt";
+
+  playback_list_results = M_OpenFile(results_name, "wb");
+
+  if (!playback_list_results)
+    I_Error("Unable to open %s for writing", results_name);
+}
+
+// The first demo that can be found decides the resources to load
+static const char* dsda_FirstPlaybackListFile(void) {
+  int i;
+
+  for (i = 0; i < playback_list_count; ++i) {
+    dsda_UpdatePlaybackName(playback_list[i], false);
+    playback_filename = I_FindFile(playback_name, ".lmp");
+
+    if (playback_filename)
+      return playback_filename;
+  }
+
+  I_Error("Unable to find any demo from the demo list");
+
+  return NULL;
+}
+
 const char* dsda_ParsePlaybackOptions(void) {
   dsda_arg_t* arg;
 
@@ -173,9 +223,415 @@ const char* dsda_ParsePlaybackOptions(void) {
     return playback_filename;
   }
 
+  arg = dsda_Arg(dsda_arg_playdemolist);
+  if (arg->found) {
+    playdemolist_arg = arg;
+    fastdemo = true;
+    dsda_LoadPlaybackList(arg);
+    return dsda_FirstPlaybackListFile();
+  }
+
   return NULL;
 }
 
+static void dsda_WritePlaybackListRecord(void) {
+  FILE* f = playback_list_results;
+
+  fprintf(f, "demo %s\n", playback_name);
+  fprintf(f, "tics %d\n", playback_tics);
+  fprintf(f, "total %d:%02d\n",
+          totalleveltimes / TICRATE / 60, (totalleveltimes % (60 * TICRATE)) / TICRATE);
+
+  if (dsda_StateChecksumDesyncTic())
+    fprintf(f, "desync %d\n", dsda_StateChecksumDesyncTic());
+
+  if (stats_level) {
+    fprintf(f, "levelstat\n");
+    e6y_WriteStatsToStream(f);
+  }
+
+  if (dsda_analysis) {
+    fprintf(f, "analysis\n");
+    dsda_WriteAnalysisToStream(f);
+  }
+
+  fprintf(f, "end\n");
+  fflush(f);
+}
+
+static int dsda_NextPlaybackListIndex(void);
+
+static void dsda_WritePlaybackListFailure(const char* reason, const char* detail) {
+  FILE* f = playback_list_results;
+
+  fprintf(f, "demo %s\n", playback_list[playback_list_index]);
+
+  if (detail)
+    fprintf(f, "%s %s\n", reason, detail);
+  else
+    fprintf(f, "%s\n", reason);
+
+  fprintf(f, "end\n");
+  fflush(f);
+}
+
+// Every demo in the list is played with the resource set loaded at startup.
+// Only the per-demo state (footer params, tracking, stats) is reset in between.
+// Demos that can't be found or that need other resources get a failure record.
+// Returns false when the list is exhausted.
+static dboolean dsda_StartPlaybackListDemo(int index) {
+  for (; index < playback_list_count; index = dsda_NextPlaybackListIndex()) {
+    const char* mismatch;
+
+    playback_list_index = index;
+
+    dsda_UpdatePlaybackName(playback_list[index], false);
+    playback_filename = I_FindFile(playback_name, ".lmp");
+
+    if (!playback_filename) {
+      lprintf(LO_WARN, "-playdemolist: unable to find %s\n", playback_name);
+      dsda_WritePlaybackListFailure("missing", NULL);
+      continue;
+    }
+
+    dsda_LoadExDemo(playback_filename);
+
+    mismatch = dsda_ExDemoResourceMismatch();
+    if (mismatch) {
+      lprintf(LO_WARN, "-playdemolist: %s needs %s\n", playback_name, mismatch);
+      dsda_WritePlaybackListFailure("mismatch", mismatch);
+      continue;
+    }
+
+    nomonsters = clnomonsters = dsda_Flag(dsda_arg_nomonsters);
+    respawnparm = clrespawnparm = dsda_Flag(dsda_arg_respawn);
+    fastparm = clfastparm = dsda_Flag(dsda_arg_fast);
+
+    G_ReloadDefaults();
+    D_InitFakeNetGame();
+    deathmatch = false;
+
+    e6y_ResetStats();
+    dsda_ResetAnalysis();
+    dsda_ForgetAutoKeyFrames();
+
+    G_DeferedPlayDemo(playback_name);
+    userdemo = true;
+
+    return true;
+  }
+
+  return false;
+}
+
+#ifndef _WIN32
+
+// Workers claim demos from a counter shared with all forked processes
+static int* playback_worker_queue;
+static dboolean playback_worker;
+
+typedef struct {
+  pid_t pid;
+  int fd;
+  char* buffer;
+  size_t length;
+} playback_worker_t;
+
+static int dsda_PlaybackListJobs(void) {
+  int jobs;
+  dsda_arg_t* arg;
+
+  arg = dsda_Arg(dsda_arg_playdemolist_jobs);
+  if (!arg->found)
+    return 1;
+
+  jobs = arg->value.v_int;
+  if (!jobs)
+    jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (jobs > playback_list_count)
+    jobs = playback_list_count;
+
+  if (jobs > 1 && !(dsda_Flag(dsda_arg_nodraw) && dsda_Flag(dsda_arg_nosound))) {
+    lprintf(LO_WARN, "-playdemolist_jobs requires -nodraw and -nosound, using one process\n");
+    jobs = 1;
+  }
+
+  return jobs < 1 ? 1 : jobs;
+}
+
+// Pass on every complete record (ending in an "end" line) received so far
+static void dsda_FlushPlaybackWorker(playback_worker_t* worker, dboolean all) {
+  size_t complete;
+
+  complete = worker->length;
+
+  if (!all) {
+    while (complete >= 4) {
+      const char* p = worker->buffer + complete - 4;
+
+      if (!memcmp(p, "end\n", 4) && (p == worker->buffer || p[-1] == '\n'))
+        break;
+
+      --complete;
+    }
+
+    if (complete < 4)
+      return;
+  }
+
+  fwrite(worker->buffer, 1, complete, playback_list_results);
+  fflush(playback_list_results);
+
+  worker->length -= complete;
+  memmove(worker->buffer, worker->buffer + complete, worker->length);
+}
+
+static void dsda_SupervisePlaybackWorkers(playback_worker_t* workers, int jobs) {
+  int i;
+  int active;
+  int failed = 0;
+  struct pollfd* pfds;
+
+  pfds = Z_Calloc(jobs, sizeof(*pfds));
+
+  for (i = 0; i < jobs; ++i) {
+    pfds[i].fd = workers[i].fd;
+    pfds[i].events = POLLIN;
+  }
+
+  active = jobs;
+  while (active) {
+    if (poll(pfds, jobs, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+
+      I_Error("dsda_SupervisePlaybackWorkers: poll failed (%s)", strerror(errno));
+    }
+
+    for (i = 0; i < jobs; ++i) {
+      char chunk[4096];
+      ssize_t length;
+
+      if (pfds[i].fd < 0 || !pfds[i].revents)
+        continue;
+
+      length = read(pfds[i].fd, chunk, sizeof(chunk));
+
+      if (length > 0) {
+        workers[i].buffer = Z_Realloc(workers[i].buffer, workers[i].length + length);
+        memcpy(workers[i].buffer + workers[i].length, chunk, length);
+        workers[i].length += length;
+
+        dsda_FlushPlaybackWorker(&workers[i], false);
+      }
+      else if (length == 0 || errno != EINTR) {
+        dsda_FlushPlaybackWorker(&workers[i], true);
+        close(pfds[i].fd);
+        pfds[i].fd = -1;
+        --active;
+      }
+    }
+  }
+
+  for (i = 0; i < jobs; ++i) {
+    int status;
+
+    waitpid(workers[i].pid, &status, 0);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+      lprintf(LO_WARN, "-playdemolist: worker %d did not finish cleanly\n", i);
+      failed = true;
+    }
+
+    Z_Free(workers[i].buffer);
+  }
+
+  Z_Free(pfds);
+
+  fclose(playback_list_results);
+  playback_list_results = NULL;
+
+  I_SafeExit(failed ? -1 : 0);
+}
+
+// Forked workers share the loaded wads, lump cache and mapped files with the
+//  supervisor copy-on-write, so each one starts playing without any setup.
+// Returns true in a worker that has started its first demo.
+static dboolean dsda_StartPlaybackWorkers(void) {
+  int i;
+  int jobs;
+  playback_worker_t* workers;
+
+  jobs = dsda_PlaybackListJobs();
+  if (jobs < 2)
+    return false;
+
+  playback_worker_queue = mmap(NULL, sizeof(*playback_worker_queue), PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (playback_worker_queue == MAP_FAILED)
+    I_Error("dsda_StartPlaybackWorkers: unable to map work queue (%s)", strerror(errno));
+
+  *playback_worker_queue = 0;
+
+  lprintf(LO_INFO, "Playing %d demos with %d workers\n", playback_list_count, jobs);
+
+  fflush(playback_list_results);
+  fflush(stdout);
+  fflush(stderr);
+
+  workers = Z_Calloc(jobs, sizeof(*workers));
+
+  for (i = 0; i < jobs; ++i) {
+    int fds[2];
+    pid_t pid;
+
+    if (pipe(fds))
+      I_Error("dsda_StartPlaybackWorkers: pipe failed (%s)", strerror(errno));
+
+    pid = fork();
+
+    if (pid < 0)
+      I_Error("dsda_StartPlaybackWorkers: fork failed (%s)", strerror(errno));
+
+    if (pid == 0) {
+      int index;
+
+      close(fds[0]);
+      Z_Free(workers);
+
+      playback_worker = true;
+      dsda_SetBenchmarkWorker(i);
+
+      // The supervisor owns the results file, records go through the pipe
+      playback_list_results = fdopen(fds[1], "wb");
+      if (!playback_list_results)
+        _exit(-1);
+
+      index = __sync_fetch_and_add(playback_worker_queue, 1);
+      if (!dsda_StartPlaybackListDemo(index)) {
+        fclose(playback_list_results);
+        _exit(0);
+      }
+
+      return true;
+    }
+
+    close(fds[1]);
+    workers[i].pid = pid;
+    workers[i].fd = fds[0];
+  }
+
+  dsda_SupervisePlaybackWorkers(workers, jobs);
+
+  return false;
+}
+
+static int dsda_NextPlaybackListIndex(void) {
+  if (playback_worker_queue)
+    return __sync_fetch_and_add(playback_worker_queue, 1);
+
+  return playback_list_index + 1;
+}
+
+// A failing worker records the demo and leaves without running the exit
+//  sequence, which belongs to the supervisor (config, stats, traces, etc.)
+void dsda_AbortPlaybackWorker(const char* error) {
+  if (!playback_worker)
+    return;
+
+  if (playback_list_results) {
+    dsda_WritePlaybackListFailure("error", error);
+    fclose(playback_list_results);
+  }
+
+  _exit(-1);
+}
+
+#else
+
+static dboolean dsda_StartPlaybackWorkers(void) {
+  if (dsda_Flag(dsda_arg_playdemolist_jobs))
+    lprintf(LO_WARN, "-playdemolist_jobs is not supported on this platform\n");
+
+  return false;
+}
+
+static int dsda_NextPlaybackListIndex(void) {
+  return playback_list_index + 1;
+}
+
+void dsda_AbortPlaybackWorker(const char* error) {
+}
+
+#endif
+
+dboolean dsda_AdvancePlaybackList(void) {
+  if (!playback_list_results)
+    return false;
+
+  dsda_WritePlaybackListRecord();
+
+  if (dsda_StartPlaybackListDemo(dsda_NextPlaybackListIndex()))
+    return true;
+
+  fclose(playback_list_results);
+  playback_list_results = NULL;
+
+#ifndef _WIN32
+  // Leave the config, stats files, etc. to the supervisor
+  if (playback_worker) {
+    dsda_FinishBenchmark();
+    _exit(0);
+  }
+#endif
+
+  return false;
+}
+
+void dsda_ExecutePlaybackOptions(void) {
+  if (playdemo_arg)
+  {
+    G_DeferedPlayDemo(playback_name);
+    userdemo = true;
+  }
+  else if (playlump_arg) {
+    if (W_CheckNumForName(playback_name) == LUMP_NOT_FOUND)
+      I_Error("Unable to find required internal demo lump \"%s\"", playback_name);
+
+    G_DeferedPlayDemo(playback_name);
+    userdemo = true;
+  }
+  else if (fastdemo_arg) {
+    G_DeferedPlayDemo(playback_name);
+    fastdemo = true;
+    timingdemo = true;
+    userdemo = true;
+  }
+  else if (timedemo_arg)
+  {
+    G_DeferedPlayDemo(playback_name);
+    singletics = true;
+    timingdemo = true;
+    userdemo = true;
+  }
+  else if (recordfromto_arg) {
+    userdemo = true;
+    G_ContinueDemo(playback_name);
+  }
+  else if (playdemolist_arg) {
+    fastdemo = true;
+    timingdemo = true;
+    userdemo = true;
+
+    if (!dsda_StartPlaybackWorkers() && !dsda_StartPlaybackListDemo(0)) {
+      fclose(playback_list_results);
+      playback_list_results = NULL;
+      I_SafeExit(0);
+    }
+  }
+}
+
 void dsda_InitDemoPlayback(void) {
   demoplayback = true;
 }
@@ -211,6 +667,8 @@ void dsda_ClearPlaybackStream(void) {
 
   demoplayback = false;
   userdemo = false;
+
+  dsda_CloseSeekIndex();
 }
 
 static dboolean dsda_EndOfPlaybackStream(void) {
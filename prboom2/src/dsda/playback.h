@@ -25,6 +25,8 @@ dboolean dsda_JumpToLogicTic(int tic);
 dboolean dsda_JumpToLogicTicFrom(int tic, int from_tic);
 void dsda_ExecutePlaybackOptions(void);
 const char* dsda_ParsePlaybackOptions(void);
+dboolean dsda_AdvancePlaybackList(void);
+void dsda_AbortPlaybackWorker(const char* error);
 const char* dsda_PlaybackName(void);
 void dsda_ClearPlaybackStream(void);
 void dsda_InitDemoPlayback(void);
@@ -15,11 +15,47 @@
 //	DSDA Render Stats
 //
 
+#include <stdlib.h>
+
+#include "dsda/signal_context.h"
 #include "dsda/time.h"
 #include "dsda/utility.h"
 
 #include "render_stats.h"
 
+// Stage samples are microseconds. Past the sample limit in one interval,
+//   the oldest samples are overwritten, so p99 stays a close estimate.
+#define STAGE_SAMPLE_LIMIT 2048
+
+typedef struct {
+  unsigned long long start;
+  unsigned int frame_time;
+  dboolean ran;
+  unsigned long long interval_time;
+  unsigned int interval_max;
+  int interval_frames;
+  unsigned int samples[STAGE_SAMPLE_LIMIT];
+  int sample_count;
+  int next_sample;
+} render_stage_t;
+
+static const char* render_stage_names[DSDA_RENDER_STAGE_COUNT] = {
+  [dsda_render_stage_setup] = "SETUP",
+  [dsda_render_stage_bsp] = "BSP",
+  [dsda_render_stage_planes] = "PLANES",
+  [dsda_render_stage_masked] = "MASKED",
+  [dsda_render_stage_scene] = "SCENE",
+  [dsda_render_stage_status_bar] = "STBAR",
+  [dsda_render_stage_hud] = "HUD",
+  [dsda_render_stage_finish] = "BLIT",
+};
+
+static render_stage_t render_stages[DSDA_RENDER_STAGE_COUNT];
+static dboolean publish_stages;
+
+int dsda_render_stage_timing;
+dsda_render_stage_stats_t dsda_render_stage_stats[DSDA_RENDER_STAGE_COUNT];
+
 static dsda_render_stats_t frame_stats;
 static dsda_render_stats_t interval_stats;
 static int frame_count;
@@ -44,6 +80,8 @@ void dsda_BeginRenderStats(void) {
   ZERO_DATA(interval_stats);
   ZERO_DATA(dsda_render_stats);
   ZERO_DATA(dsda_render_stats_max);
+  ZERO_DATA(render_stages);
+  ZERO_DATA(dsda_render_stage_stats);
 
   dsda_StartTimer(dsda_timer_render_stats);
 }
@@ -84,6 +122,143 @@ void dsda_UpdateRenderStats(void) {
     dsda_UpdateMaxValues(&dsda_render_stats_max, &dsda_render_stats);
     dsda_render_stats_fps = frame_count * 1000 / dsda_ElapsedTimeMS(dsda_timer_render_stats);
     frame_count = 0;
+    publish_stages = true;
     dsda_StartTimer(dsda_timer_render_stats);
   }
 }
+
+void dsda_SetRenderStageTiming(int on) {
+  dsda_render_stage_timing = on;
+
+  ZERO_DATA(render_stages);
+  ZERO_DATA(dsda_render_stage_stats);
+}
+
+const char* dsda_RenderStageName(int stage) {
+  return render_stage_names[stage];
+}
+
+static int dsda_RenderStage(int context) {
+  switch (context) {
+    case sf_setup_frame:
+    case sf_clear:
+    case sf_init_scene:
+    case sf_gl_frustum:
+      return dsda_render_stage_setup;
+    case sf_bsp_nodes:
+      return dsda_render_stage_bsp;
+    case sf_draw_planes:
+      return dsda_render_stage_planes;
+    case sf_draw_masked:
+      return dsda_render_stage_masked;
+    case sf_draw_scene:
+      return dsda_render_stage_scene;
+    case sf_status_bar:
+      return dsda_render_stage_status_bar;
+    case sf_hud:
+      return dsda_render_stage_hud;
+    case sf_finish_update:
+      return dsda_render_stage_finish;
+    default:
+      return -1;
+  }
+}
+
+static int dsda_CompareStageSamples(const void* a, const void* b) {
+  unsigned int x = *(const unsigned int*) a;
+  unsigned int y = *(const unsigned int*) b;
+
+  return (x > y) - (x < y);
+}
+
+static void dsda_PublishRenderStages(void) {
+  int i;
+  static unsigned int sorted[STAGE_SAMPLE_LIMIT];
+
+  for (i = 0; i < DSDA_RENDER_STAGE_COUNT; ++i) {
+    render_stage_t* stage = &render_stages[i];
+    dsda_render_stage_stats_t* stats = &dsda_render_stage_stats[i];
+
+    stats->frames = stage->interval_frames;
+
+    if (stage->interval_frames) {
+      int p99;
+
+      memcpy(sorted, stage->samples, stage->sample_count * sizeof(*sorted));
+      qsort(sorted, stage->sample_count, sizeof(*sorted), dsda_CompareStageSamples);
+
+      p99 = (stage->sample_count * 99 + 99) / 100 - 1;
+
+      stats->average = (double) stage->interval_time / stage->interval_frames / 1000;
+      stats->max = (double) stage->interval_max / 1000;
+      stats->p99 = (double) sorted[p99] / 1000;
+    }
+    else
+      stats->average = stats->max = stats->p99 = 0;
+
+    stage->interval_time = 0;
+    stage->interval_max = 0;
+    stage->interval_frames = 0;
+    stage->sample_count = 0;
+    stage->next_sample = 0;
+  }
+}
+
+static void dsda_EndRenderStageFrame(void) {
+  int i;
+
+  for (i = 0; i < DSDA_RENDER_STAGE_COUNT; ++i) {
+    render_stage_t* stage = &render_stages[i];
+
+    if (!stage->ran)
+      continue;
+
+    stage->interval_time += stage->frame_time;
+    ++stage->interval_frames;
+
+    if (stage->interval_max < stage->frame_time)
+      stage->interval_max = stage->frame_time;
+
+    stage->samples[stage->next_sample] = stage->frame_time;
+    stage->next_sample = (stage->next_sample + 1) % STAGE_SAMPLE_LIMIT;
+    if (stage->sample_count < STAGE_SAMPLE_LIMIT)
+      ++stage->sample_count;
+
+    dsda_render_stage_stats[i].current = (double) stage->frame_time / 1000;
+
+    stage->frame_time = 0;
+    stage->ran = false;
+  }
+
+  if (publish_stages) {
+    publish_stages = false;
+    dsda_PublishRenderStages();
+  }
+}
+
+void dsda_BeginRenderStage(int context) {
+  int i;
+
+  i = dsda_RenderStage(context);
+
+  if (i >= 0)
+    render_stages[i].start = dsda_TimeNS();
+}
+
+void dsda_EndRenderStage(int context) {
+  int i;
+
+  // The display context wraps the whole frame
+  if (context == sf_display) {
+    dsda_EndRenderStageFrame();
+    return;
+  }
+
+  i = dsda_RenderStage(context);
+
+  if (i >= 0 && render_stages[i].start) {
+    render_stages[i].frame_time += (dsda_TimeNS() - render_stages[i].start) / 1000;
+    render_stages[i].start = 0;
+    render_stages[i].ran = true;
+  }
+}
@@ -24,6 +24,26 @@ typedef struct {
   int vissprites;
 } dsda_render_stats_t;
 
+typedef enum {
+  dsda_render_stage_setup,
+  dsda_render_stage_bsp,
+  dsda_render_stage_planes,
+  dsda_render_stage_masked,
+  dsda_render_stage_scene,
+  dsda_render_stage_status_bar,
+  dsda_render_stage_hud,
+  dsda_render_stage_finish,
+  DSDA_RENDER_STAGE_COUNT
+} dsda_render_stage_t;
+
+typedef struct {
+  int frames;
+  double current;
+  double average;
+  double max;
+  double p99;
+} dsda_render_stage_stats_t;
+
 void dsda_BeginRenderStats(void);
 void dsda_RecordVisSprite(void);
 void dsda_RecordVisSprites(int n);
@@ -32,5 +52,7 @@ void dsda_RecordVisPlanes(int n);
 void dsda_RecordDrawSeg(void);
 void dsda_RecordDrawSegs(int n);
 void dsda_UpdateRenderStats(void);
+void dsda_SetRenderStageTiming(int on);
+const char* dsda_RenderStageName(int stage);
 
 #endif
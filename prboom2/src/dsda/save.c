@@ -162,6 +162,12 @@ void dsda_ArchiveAll(void) {
   dsda_ArchiveInternal();
 }
 
+// The used feature mask at the end of the archive is bookkeeping,
+//   so comparisons of game state stop before it
+int dsda_ArchiveStateLength(int length) {
+  return length - sizeof(uint64_t);
+}
+
 void dsda_UnArchiveAll(void) {
   dsda_UnArchiveContext();
 
@@ -20,6 +20,7 @@
 
 void dsda_ArchiveAll(void);
 void dsda_UnArchiveAll(void);
+int dsda_ArchiveStateLength(int length);
 void dsda_InitSaveDir(void);
 char* dsda_SaveDir(void);
 char* dsda_SaveGameName(int slot, dboolean via_excmd);
@@ -0,0 +1,392 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Seek Index
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "doomstat.h"
+#include "g_game.h"
+#include "g_overflow.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "md5.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/data_organizer.h"
+#include "dsda/demo.h"
+#include "dsda/features.h"
+#include "dsda/key_frame.h"
+#include "dsda/utility.h"
+
+#include "seek_index.h"
+
+// The seek index caches key frames from demo playback in the data dir,
+//   under the demo (with playback settings) and wad checksums, so later
+//   playbacks can jump anywhere.
+// Index key frames carry no recording buffer, so the index is not used
+//   once playback turns into recording (e.g., after joining the demo).
+// The file is a header followed by appended entries. Entries are only
+//   read when a seek needs them, and a torn entry at the end is ignored.
+
+#define SEEK_INDEX_MAGIC "DSDASEEK"
+#define SEEK_INDEX_ENTRY_MAGIC 0x314b4653 // "SFK1"
+
+typedef struct {
+  char magic[8];
+  char version[32];
+} seek_index_header_t;
+
+typedef struct {
+  int magic;
+  int tic;
+  int full_length;
+  int length;
+} seek_index_entry_header_t;
+
+typedef struct {
+  int tic;
+  long offset;
+  int full_length;
+  int length;
+} seek_index_entry_t;
+
+static FILE* seek_index_file;
+static seek_index_entry_t* seek_index_entries;
+static int seek_index_count;
+static int seek_index_capacity;
+static long seek_index_end;
+static int seek_index_interval;
+static dsda_cksum_t seek_index_wad_cksum;
+
+// The loaded lump directory identifies the wads without reading any lump data
+static void dsda_SeekIndexWadCheckSum(void) {
+  int i;
+  struct MD5Context md5;
+
+  if (seek_index_wad_cksum.string[0])
+    return;
+
+  MD5Init(&md5);
+
+  for (i = 0; i < numlumps; ++i) {
+    int entry[2];
+
+    entry[0] = lumpinfo[i].size;
+    entry[1] = lumpinfo[i].position;
+
+    MD5Update(&md5, (const byte*) lumpinfo[i].name, strlen(lumpinfo[i].name));
+    MD5Update(&md5, (const byte*) entry, sizeof(entry));
+  }
+
+  MD5Final(seek_index_wad_cksum.bytes, &md5);
+  dsda_TranslateCheckSum(&seek_index_wad_cksum);
+}
+
+// Settings from the command line or the footer that change how the demo plays
+static void dsda_SeekIndexDemoCheckSum(dsda_cksum_t* cksum, const byte* demo, int length) {
+  int i;
+  int settings[7 + OVERFLOW_MAX];
+  byte features[FEATURE_SIZE] = { 0 };
+  struct MD5Context md5;
+  dsda_arg_t* arg;
+
+  arg = dsda_Arg(dsda_arg_spechit);
+
+  settings[0] = compatibility_level;
+  settings[1] = spechit_baseaddr ? spechit_baseaddr :
+                arg->found ? arg->value.v_int : DEFAULT_SPECHIT_MAGIC;
+  settings[2] = solo_net;
+  settings[3] = coop_spawns;
+  settings[4] = respawnparm;
+  settings[5] = fastparm;
+  settings[6] = nomonsters;
+
+  for (i = 0; i < OVERFLOW_MAX; ++i)
+    settings[7 + i] = EMULATE(i);
+
+  dsda_GetDemoCheckSum(cksum, features, demo, length);
+
+  MD5Init(&md5);
+  MD5Update(&md5, cksum->bytes, sizeof(cksum->bytes));
+  MD5Update(&md5, (const byte*) settings, sizeof(settings));
+  MD5Final(cksum->bytes, &md5);
+
+  dsda_TranslateCheckSum(cksum);
+}
+
+static char* dsda_SeekIndexFileName(const byte* demo, int length) {
+  dsda_cksum_t demo_cksum;
+  const char* data_root;
+  char* dir;
+  char* name;
+  int name_length;
+
+  dsda_SeekIndexWadCheckSum();
+  dsda_SeekIndexDemoCheckSum(&demo_cksum, demo, length);
+
+  data_root = dsda_DataRoot();
+
+  name_length = strlen(data_root) + 12; // "/seek_index\0"
+  dir = Z_Malloc(name_length);
+  snprintf(dir, name_length, "%s/seek_index", data_root);
+  M_MakeDir(dir, true);
+
+  name_length = strlen(dir) + 71; // "/<cksum (32)>-<cksum (32)>.dsi\0"
+  name = Z_Malloc(name_length);
+  snprintf(name, name_length, "%s/%s-%s.dsi", dir, demo_cksum.string, seek_index_wad_cksum.string);
+
+  Z_Free(dir);
+
+  return name;
+}
+
+static void dsda_AddSeekIndexEntry(seek_index_entry_header_t* header, long offset) {
+  seek_index_entry_t* entry;
+
+  if (seek_index_count == seek_index_capacity) {
+    seek_index_capacity = seek_index_capacity ? seek_index_capacity * 2 : 64;
+    seek_index_entries = Z_Realloc(seek_index_entries,
+                                   seek_index_capacity * sizeof(*seek_index_entries));
+  }
+
+  entry = &seek_index_entries[seek_index_count++];
+  entry->tic = header->tic;
+  entry->offset = offset;
+  entry->full_length = header->full_length;
+  entry->length = header->length;
+}
+
+static void dsda_ScanSeekIndex(void) {
+  long file_length;
+
+  fseek(seek_index_file, 0, SEEK_END);
+  file_length = ftell(seek_index_file);
+
+  seek_index_end = sizeof(seek_index_header_t);
+  fseek(seek_index_file, seek_index_end, SEEK_SET);
+
+  while (1) {
+    seek_index_entry_header_t header;
+    long offset;
+
+    if (fread(&header, sizeof(header), 1, seek_index_file) != 1)
+      break;
+
+    offset = seek_index_end + sizeof(header);
+
+    if (
+      header.magic != SEEK_INDEX_ENTRY_MAGIC ||
+      header.length <= 0 ||
+      header.full_length <= 0 ||
+      header.length > file_length - offset
+    ) break;
+
+    dsda_AddSeekIndexEntry(&header, offset);
+
+    seek_index_end = offset + header.length;
+    fseek(seek_index_file, seek_index_end, SEEK_SET);
+  }
+}
+
+static dboolean dsda_OpenSeekIndex(const char* name) {
+  seek_index_header_t header;
+  seek_index_header_t expected = { 0 };
+
+  memcpy(expected.magic, SEEK_INDEX_MAGIC, sizeof(expected.magic));
+  strncpy(expected.version, PACKAGE_VERSION, sizeof(expected.version) - 1);
+
+  seek_index_file = M_OpenFile(name, "r+b");
+
+  // Key frames are only compatible with the same version
+  if (seek_index_file) {
+    if (
+      fread(&header, sizeof(header), 1, seek_index_file) == 1 &&
+      !memcmp(&header, &expected, sizeof(header))
+    ) {
+      dsda_ScanSeekIndex();
+      return true;
+    }
+
+    fclose(seek_index_file);
+  }
+
+  seek_index_file = M_OpenFile(name, "w+b");
+
+  if (!seek_index_file)
+    return false;
+
+  if (fwrite(&expected, sizeof(expected), 1, seek_index_file) != 1) {
+    fclose(seek_index_file);
+    seek_index_file = NULL;
+    return false;
+  }
+
+  seek_index_end = sizeof(expected);
+
+  return true;
+}
+
+void dsda_CloseSeekIndex(void) {
+  if (seek_index_file) {
+    fclose(seek_index_file);
+    seek_index_file = NULL;
+  }
+
+  seek_index_count = 0;
+}
+
+void dsda_InitSeekIndex(const byte* demo, int length) {
+  dsda_arg_t* arg;
+  char* name;
+
+  dsda_CloseSeekIndex();
+
+  arg = dsda_Arg(dsda_arg_seek_index);
+
+  if (!arg->found)
+    return;
+
+  seek_index_interval = 35 * arg->value.v_int;
+
+  name = dsda_SeekIndexFileName(demo, length);
+
+  if (dsda_OpenSeekIndex(name))
+    lprintf(LO_INFO, "Seek index: %s (%d key frames)\n", name, seek_index_count);
+  else
+    lprintf(LO_WARN, "Seek index: unable to open %s\n", name);
+
+  Z_Free(name);
+}
+
+static seek_index_entry_t* dsda_FindSeekIndexEntry(int tic) {
+  int i;
+  seek_index_entry_t* closest = NULL;
+
+  for (i = 0; i < seek_index_count; ++i)
+    if (seek_index_entries[i].tic <= tic)
+      if (!closest || seek_index_entries[i].tic > closest->tic)
+        closest = &seek_index_entries[i];
+
+  return closest;
+}
+
+int dsda_SeekIndexTic(int tic) {
+  seek_index_entry_t* entry;
+
+  if (demorecording)
+    return -1;
+
+  entry = dsda_FindSeekIndexEntry(tic);
+
+  return entry ? entry->tic : -1;
+}
+
+dboolean dsda_RestoreSeekIndex(int tic) {
+  seek_index_entry_t* entry;
+  dsda_key_frame_t key_frame = { 0 };
+  byte* compressed;
+  uLongf length;
+
+  if (demorecording)
+    return false;
+
+  entry = dsda_FindSeekIndexEntry(tic);
+
+  if (!entry)
+    return false;
+
+  compressed = Z_Malloc(entry->length);
+  key_frame.buffer = Z_Malloc(entry->full_length);
+  length = entry->full_length;
+
+  if (
+    fseek(seek_index_file, entry->offset, SEEK_SET) ||
+    fread(compressed, entry->length, 1, seek_index_file) != 1 ||
+    uncompress(key_frame.buffer, &length, compressed, entry->length) != Z_OK
+  ) {
+    lprintf(LO_WARN, "Seek index: unable to read key frame at tic %d\n", entry->tic);
+
+    Z_Free(compressed);
+    Z_Free(key_frame.buffer);
+
+    return false;
+  }
+
+  key_frame.buffer_length = length;
+
+  dsda_RestoreKeyFrame(&key_frame, true);
+
+  Z_Free(compressed);
+  Z_Free(key_frame.buffer);
+
+  return true;
+}
+
+static void dsda_AppendSeekIndex(void) {
+  dsda_key_frame_t key_frame = { 0 };
+  seek_index_entry_header_t header;
+  byte* compressed;
+  uLongf length;
+
+  dsda_StoreKeyFrame(&key_frame, false, false);
+
+  length = compressBound(key_frame.buffer_length);
+  compressed = Z_Malloc(length);
+
+  if (compress2(compressed, &length, key_frame.buffer, key_frame.buffer_length, Z_BEST_SPEED) == Z_OK) {
+    header.magic = SEEK_INDEX_ENTRY_MAGIC;
+    header.tic = key_frame.game_tic_count;
+    header.full_length = key_frame.buffer_length;
+    header.length = length;
+
+    if (
+      !fseek(seek_index_file, seek_index_end, SEEK_SET) &&
+      fwrite(&header, sizeof(header), 1, seek_index_file) == 1 &&
+      fwrite(compressed, length, 1, seek_index_file) == 1 &&
+      !fflush(seek_index_file)
+    ) {
+      dsda_AddSeekIndexEntry(&header, seek_index_end + sizeof(header));
+      seek_index_end += sizeof(header) + length;
+    }
+    else {
+      lprintf(LO_WARN, "Seek index: write failed, no longer recording\n");
+      dsda_CloseSeekIndex();
+    }
+  }
+
+  Z_Free(compressed);
+  Z_Free(key_frame.buffer);
+}
+
+void dsda_UpdateSeekIndex(void) {
+  if (
+    !seek_index_file ||
+    !demoplayback ||
+    demorecording ||
+    gamestate != GS_LEVEL ||
+    gameaction != ga_nothing ||
+    true_logictic % seek_index_interval
+  ) return;
+
+  if (dsda_SeekIndexTic(true_logictic) == true_logictic)
+    return;
+
+  dsda_AppendSeekIndex();
+}
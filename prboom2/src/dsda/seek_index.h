@@ -0,0 +1,29 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Seek Index
+//
+
+#ifndef __DSDA_SEEK_INDEX__
+#define __DSDA_SEEK_INDEX__
+
+#include "doomtype.h"
+
+void dsda_InitSeekIndex(const byte* demo, int length);
+void dsda_CloseSeekIndex(void);
+int dsda_SeekIndexTic(int tic);
+dboolean dsda_RestoreSeekIndex(int tic);
+void dsda_UpdateSeekIndex(void);
+
+#endif
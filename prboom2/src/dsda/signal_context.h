@@ -15,6 +15,8 @@
 //	DSDA Signal Context
 //
 
+#include "dsda/trace.h"
+
 typedef enum {
   sf_display             = 0x0001,
   sf_player_view         = 0x0002,
@@ -29,9 +31,21 @@ typedef enum {
   sf_draw_scene          = 0x0400,
   sf_status_bar          = 0x0800,
   sf_hud                 = 0x1000,
+  sf_finish_update       = 0x2000,
 } signal_context_t;
 
 extern int signal_context;
 
-#define DSDA_ADD_CONTEXT(x) signal_context |= x
-#define DSDA_REMOVE_CONTEXT(x) signal_context &= ~x;
+// The contexts double as render stage markers for the render stats timer
+//   and the trace
+extern int dsda_render_stage_timing;
+
+void dsda_BeginRenderStage(int context);
+void dsda_EndRenderStage(int context);
+
+#define DSDA_ADD_CONTEXT(x) { signal_context |= x; \
+                              if (dsda_render_stage_timing) dsda_BeginRenderStage(x); \
+                              if (dsda_tracing) dsda_TraceContext(x, 'B'); }
+#define DSDA_REMOVE_CONTEXT(x) { signal_context &= ~x; \
+                                 if (dsda_render_stage_timing) dsda_EndRenderStage(x); \
+                                 if (dsda_tracing) dsda_TraceContext(x, 'E'); }
@@ -0,0 +1,401 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA State Hash
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "m_random.h"
+#include "p_mobj.h"
+#include "p_saveg.h"
+#include "p_tick.h"
+#include "r_state.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include "dsda/save.h"
+#include "dsda/time.h"
+
+#include "state_hash.h"
+
+#define DSDA_STATE_HASH_VERSION 2
+
+// Same thinker selection as the save game (P_ArchiveThinkers), but only the
+//  fields that matter for sync are hashed, and pointers are left out.
+// Specials are only counted, and many mobj and player fields are skipped, so
+//  this is a lossy desync detector. The values are embedded in demos without
+//  a version, so they must stay stable.
+
+#define HASH(h, x) h = ((h) ^ (unsigned int) (x)) * 16777619u
+#define HASH64(h, x) { HASH(h, (x) & 0xffffffff); HASH(h, (x) >> 32); }
+#define HASH_ARRAY(h, x) { int _i; \
+                           for (_i = 0; _i < sizeof(x) / sizeof(x[0]); ++_i) \
+                             HASH(h, x[_i]); }
+
+#define HASH_BASIS 2166136261u
+
+typedef struct {
+  int tic;
+  int episode;
+  int map;
+  int leveltime;
+  dsda_state_hash_t hash;
+  uint64_t archive;
+} dsda_state_hash_frame_t;
+
+static FILE* dsda_state_hash_export;
+static dboolean dsda_state_hash_export_archive;
+static unsigned long long dsda_state_hash_export_time;
+static int dsda_state_hash_export_tics;
+
+static const char* dsda_state_hash_class_names[dsda_state_hash_count] = {
+  [dsda_state_hash_rng] = "rng",
+  [dsda_state_hash_players] = "players",
+  [dsda_state_hash_mobjs] = "mobjs",
+  [dsda_state_hash_world] = "world",
+};
+
+static unsigned int dsda_HashRNG(void) {
+  unsigned int h = HASH_BASIS;
+
+  HASH_ARRAY(h, rng.seed);
+  HASH(h, rng.rndindex);
+  HASH(h, rng.prndindex);
+
+  return h;
+}
+
+static unsigned int dsda_HashPlayers(void) {
+  int i;
+  unsigned int h = HASH_BASIS;
+
+  for (i = 0; i < g_maxplayers; ++i) {
+    player_t* player;
+
+    if (!playeringame[i])
+      continue;
+
+    player = &players[i];
+
+    HASH(h, i);
+    HASH(h, player->playerstate);
+    HASH(h, player->viewz);
+    HASH(h, player->viewheight);
+    HASH(h, player->deltaviewheight);
+    HASH(h, player->bob);
+    HASH(h, player->health);
+    HASH_ARRAY(h, player->armorpoints);
+    HASH(h, player->armortype);
+    HASH_ARRAY(h, player->powers);
+    HASH_ARRAY(h, player->cards);
+    HASH(h, player->readyweapon);
+    HASH(h, player->pendingweapon);
+    HASH_ARRAY(h, player->weaponowned);
+    HASH_ARRAY(h, player->ammo);
+    HASH(h, player->attackdown);
+    HASH(h, player->usedown);
+    HASH(h, player->refire);
+    HASH(h, player->killcount);
+    HASH(h, player->itemcount);
+    HASH(h, player->secretcount);
+    HASH(h, player->damagecount);
+    HASH(h, player->bonuscount);
+  }
+
+  return h;
+}
+
+static unsigned int dsda_HashMobjs(void) {
+  thinker_t* th;
+  unsigned int h = HASH_BASIS;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+    mobj_t* mo;
+
+    if (th->function != P_MobjThinker && th->function != P_BlasterMobjThinker)
+      continue;
+
+    mo = (mobj_t*) th;
+
+    HASH(h, mo->type);
+    HASH(h, mo->x);
+    HASH(h, mo->y);
+    HASH(h, mo->z);
+    HASH(h, mo->momx);
+    HASH(h, mo->momy);
+    HASH(h, mo->momz);
+    HASH(h, mo->angle);
+    HASH(h, mo->health);
+    HASH(h, mo->tics);
+    HASH(h, mo->state ? mo->state - states : -1);
+    HASH64(h, mo->flags);
+    HASH64(h, mo->flags2);
+    HASH(h, mo->movedir);
+    HASH(h, mo->movecount);
+    HASH(h, mo->reactiontime);
+    HASH(h, mo->threshold);
+    HASH(h, mo->target ? mo->target->type : -1);
+  }
+
+  return h;
+}
+
+static unsigned int dsda_HashWorld(void) {
+  int i;
+  thinker_t* th;
+  unsigned int h = HASH_BASIS;
+
+  for (i = 0; i < numsectors; ++i) {
+    HASH(h, sectors[i].floorheight);
+    HASH(h, sectors[i].ceilingheight);
+    HASH(h, sectors[i].lightlevel);
+    HASH(h, sectors[i].special);
+  }
+
+  for (i = 0; i < numlines; ++i)
+    HASH(h, lines[i].special);
+
+  // Specials are only visible through the sectors they move, but a special
+  //  that starts or stops a tic early should still show up here
+  i = 0;
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    ++i;
+
+  HASH(h, i);
+
+  return h;
+}
+
+void dsda_StateHash(dsda_state_hash_t* hash) {
+  hash->value[dsda_state_hash_rng] = dsda_HashRNG();
+  hash->value[dsda_state_hash_players] = dsda_HashPlayers();
+  hash->value[dsda_state_hash_mobjs] = dsda_HashMobjs();
+  hash->value[dsda_state_hash_world] = dsda_HashWorld();
+}
+
+unsigned int dsda_CombinedStateHash(void) {
+  int i;
+  dsda_state_hash_t hash;
+  unsigned int h = HASH_BASIS;
+
+  dsda_StateHash(&hash);
+
+  for (i = 0; i < dsda_state_hash_count; ++i)
+    HASH(h, hash.value[i]);
+
+  return h;
+}
+
+#define HASH64_BASIS 14695981039346656037ull
+#define HASH64_PRIME 1099511628211ull
+
+// Hash of the game state in an archive written by dsda_ArchiveAll
+uint64_t dsda_HashArchive(const byte* archive, int length) {
+  uint64_t h = HASH64_BASIS;
+  const byte* end;
+
+  end = archive + dsda_ArchiveStateLength(length);
+
+  for (; archive + sizeof(uint64_t) <= end; archive += sizeof(uint64_t)) {
+    uint64_t word;
+
+    memcpy(&word, archive, sizeof(word));
+    h = (h ^ word) * HASH64_PRIME;
+  }
+
+  for (; archive < end; ++archive)
+    h = (h ^ *archive) * HASH64_PRIME;
+
+  return h;
+}
+
+// Covers everything a save game does, so equal hashes mean equal states
+uint64_t dsda_ArchiveStateHash(void) {
+  uint64_t h;
+
+  P_InitSaveBuffer();
+  dsda_ArchiveAll();
+
+  h = dsda_HashArchive(savebuffer, save_p - savebuffer);
+
+  P_FreeSaveBuffer();
+
+  return h;
+}
+
+const char* dsda_StateHashClassName(int i) {
+  return dsda_state_hash_class_names[i];
+}
+
+// The export reports what hashing cost per tic when it closes
+static void dsda_CloseStateHashExport(void) {
+  if (!dsda_state_hash_export)
+    return;
+
+  if (dsda_state_hash_export_tics)
+    lprintf(LO_INFO, "State hash export: %d tics, %llu us per tic%s\n",
+            dsda_state_hash_export_tics,
+            dsda_state_hash_export_time / 1000 / dsda_state_hash_export_tics,
+            dsda_state_hash_export_archive ? " (with save game hash)" : "");
+
+  fclose(dsda_state_hash_export);
+  dsda_state_hash_export = NULL;
+}
+
+void dsda_InitStateHashExport(const char* name, dboolean archive) {
+  int version;
+  int flags;
+  char* filename;
+
+  filename = Z_Malloc(strlen(name) + 4 + 1);
+  AddDefaultExtension(strcpy(filename, name), ".hsh");
+
+  dsda_state_hash_export = M_OpenFile(filename, "wb");
+
+  if (dsda_state_hash_export == NULL)
+    I_Error("dsda_InitStateHashExport: failed to open %s", name);
+
+  version = DSDA_STATE_HASH_VERSION;
+  fwrite(&version, sizeof(int), 1, dsda_state_hash_export);
+
+  dsda_state_hash_export_archive = archive;
+  flags = archive;
+  fwrite(&flags, sizeof(int), 1, dsda_state_hash_export);
+
+  Z_Free(filename);
+
+  I_AtExit(dsda_CloseStateHashExport, true, "dsda_CloseStateHashExport", exit_priority_normal);
+}
+
+void dsda_UpdateStateHashExport(void) {
+  dsda_state_hash_frame_t frame;
+  unsigned long long start;
+
+  if (!dsda_state_hash_export)
+    return;
+
+  start = dsda_TimeNS();
+
+  frame.tic = true_logictic;
+  frame.episode = gameepisode;
+  frame.map = gamemap;
+  frame.leveltime = leveltime;
+  dsda_StateHash(&frame.hash);
+  frame.archive = dsda_state_hash_export_archive ? dsda_ArchiveStateHash() : 0;
+
+  dsda_state_hash_export_time += dsda_TimeNS() - start;
+  ++dsda_state_hash_export_tics;
+
+  fwrite(&frame, sizeof(frame), 1, dsda_state_hash_export);
+}
+
+static FILE* dsda_OpenStateHashFile(const char* name, dboolean* archive) {
+  FILE* fstream;
+  int version;
+  int flags;
+
+  fstream = M_OpenFile(name, "rb");
+
+  if (fstream == NULL)
+    I_Error("dsda_CompareStateHashFiles: failed to open %s", name);
+
+  if (fread(&version, sizeof(int), 1, fstream) != 1 || version != DSDA_STATE_HASH_VERSION)
+    I_Error("dsda_CompareStateHashFiles: unsupported state hash version %s", name);
+
+  if (fread(&flags, sizeof(int), 1, fstream) != 1)
+    I_Error("dsda_CompareStateHashFiles: failed to read %s", name);
+
+  *archive = (flags & 1) != 0;
+
+  return fstream;
+}
+
+int dsda_CompareStateHashFiles(const char* name_a, const char* name_b) {
+  FILE* stream_a;
+  FILE* stream_b;
+  dsda_state_hash_frame_t a, b;
+  dboolean archive_a, archive_b;
+  int frames = 0;
+  int result = 0;
+
+  stream_a = dsda_OpenStateHashFile(name_a, &archive_a);
+  stream_b = dsda_OpenStateHashFile(name_b, &archive_b);
+
+  if (archive_a != archive_b)
+    lprintf(LO_INFO, "Only one file has save game hashes, comparing the state hash classes\n");
+
+  while (1) {
+    dboolean end_a, end_b;
+
+    end_a = fread(&a, sizeof(a), 1, stream_a) != 1;
+    end_b = fread(&b, sizeof(b), 1, stream_b) != 1;
+
+    if (end_a && end_b)
+      break;
+
+    if (end_a || end_b) {
+      lprintf(LO_INFO, "State hashes match for %d tics, then %s ends first\n",
+              frames, end_a ? name_a : name_b);
+      result = 1;
+      break;
+    }
+
+    if (a.tic != b.tic || a.episode != b.episode || a.map != b.map || a.leveltime != b.leveltime) {
+      lprintf(LO_INFO, "First divergence at tic %d: level timeline differs "
+                       "(E%dM%d at %d vs E%dM%d at %d)\n",
+              a.tic, a.episode, a.map, a.leveltime, b.episode, b.map, b.leveltime);
+      result = 1;
+      break;
+    }
+
+    if (memcmp(&a.hash, &b.hash, sizeof(a.hash))) {
+      int i;
+
+      lprintf(LO_INFO, "First divergence at tic %d (E%dM%d, level time %d):",
+              a.tic, a.episode, a.map, a.leveltime);
+
+      for (i = 0; i < dsda_state_hash_count; ++i)
+        if (a.hash.value[i] != b.hash.value[i])
+          lprintf(LO_INFO, " %s", dsda_StateHashClassName(i));
+
+      lprintf(LO_INFO, "\n");
+      result = 1;
+      break;
+    }
+
+    // Divergence the state hash classes do not cover
+    if (archive_a && archive_b && a.archive != b.archive) {
+      lprintf(LO_INFO, "First divergence at tic %d (E%dM%d, level time %d): save game state\n",
+              a.tic, a.episode, a.map, a.leveltime);
+      result = 1;
+      break;
+    }
+
+    ++frames;
+  }
+
+  if (!result)
+    lprintf(LO_INFO, "State hashes match for all %d tics\n", frames);
+
+  fclose(stream_a);
+  fclose(stream_b);
+
+  return result;
+}
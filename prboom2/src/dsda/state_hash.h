@@ -0,0 +1,64 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA State Hash
+//
+
+#ifndef __DSDA_STATE_HASH__
+#define __DSDA_STATE_HASH__
+
+#include "doomtype.h"
+
+typedef enum {
+  dsda_state_hash_rng,
+  dsda_state_hash_players,
+  dsda_state_hash_mobjs,
+  dsda_state_hash_world,
+  dsda_state_hash_count,
+} dsda_state_hash_class_t;
+
+typedef struct {
+  unsigned int value[dsda_state_hash_count];
+} dsda_state_hash_t;
+
+// The state hash is a desync detector: it covers the fields where a desync
+//   usually shows first, not the whole game state. Two states with the same
+//   hash are not necessarily the same, use dsda_ArchiveStateHash for that.
+// rng:     the seed table and both random indices
+// players: for each player in game, playerstate, viewz, viewheight,
+//          deltaviewheight, bob, health, armor, powers, cards, weapons, ammo,
+//          attackdown, usedown, refire, the kill, item and secret counts,
+//          damagecount and bonuscount
+// mobjs:   for each mobj, type, position, momentum, angle, health, tics,
+//          state, flags, flags2, movedir, movecount, reactiontime,
+//          threshold and the type of its target
+// world:   sector heights, light and special, line specials, and the
+//          number of thinkers
+// Not covered: mobj fields not listed above (including tracer, lastenemy,
+//   special1/2, floorz and ceilingz), player fields not listed above (such
+//   as inventory, attacker and extralight), sector thinker internals,
+//   sidedef textures and offsets, line flags, ACS and the level counters.
+// With -state_hash_archive the export also stores dsda_ArchiveStateHash for
+//   every tic, which covers everything a save game does.
+void dsda_StateHash(dsda_state_hash_t* hash);
+unsigned int dsda_CombinedStateHash(void);
+
+uint64_t dsda_HashArchive(const byte* archive, int length);
+uint64_t dsda_ArchiveStateHash(void);
+const char* dsda_StateHashClassName(int i);
+void dsda_InitStateHashExport(const char* name, dboolean archive);
+void dsda_UpdateStateHashExport(void);
+int dsda_CompareStateHashFiles(const char* name_a, const char* name_b);
+
+#endif
@@ -0,0 +1,395 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Thinker Profile
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "d_deh.h"
+#include "doomdef.h"
+#include "lprintf.h"
+#include "p_spec.h"
+#include "p_tick.h"
+#include "z_zone.h"
+
+#include "dsda/ambient.h"
+#include "dsda/scroll.h"
+#include "dsda/time.h"
+#include "hexen/p_acs.h"
+#include "hexen/po_man.h"
+
+#include "thinker_profile.h"
+
+// Times are inclusive: a mobj thinker includes the actions it runs, and an
+//   action includes any actions it triggers on other mobjs.
+// The "recent" counts cover the last full second of profiled tics.
+
+#define PROFILE_HASH_SIZE 1024
+#define PROFILE_NAME_SIZE 40
+
+typedef struct {
+  unsigned long long time;
+  unsigned int calls;
+} profile_count_t;
+
+typedef struct {
+  actionf_t function;
+  char name[PROFILE_NAME_SIZE];
+  profile_count_t total;
+  profile_count_t interval;
+  profile_count_t recent;
+} profile_entry_t;
+
+typedef struct {
+  profile_entry_t* entries;
+  int size;
+} profile_table_t;
+
+#define THINKER_NAME(x) { (think_t) x, #x }
+
+static const struct {
+  think_t function;
+  const char* name;
+} thinker_names[] = {
+  THINKER_NAME(P_MobjThinker),
+  THINKER_NAME(P_BlasterMobjThinker),
+  THINKER_NAME(P_RemoveThinkerDelayed),
+  THINKER_NAME(T_MoveFloor),
+  THINKER_NAME(T_MoveCeiling),
+  THINKER_NAME(T_MoveElevator),
+  THINKER_NAME(T_VerticalDoor),
+  THINKER_NAME(T_PlatRaise),
+  THINKER_NAME(T_LightFlash),
+  THINKER_NAME(T_StrobeFlash),
+  THINKER_NAME(T_FireFlicker),
+  THINKER_NAME(T_Glow),
+  THINKER_NAME(T_Light),
+  THINKER_NAME(T_Phase),
+  THINKER_NAME(T_ZDoom_Flicker),
+  THINKER_NAME(T_ZDoom_Glow),
+  THINKER_NAME(T_Friction),
+  THINKER_NAME(T_Pusher),
+  THINKER_NAME(T_BuildPillar),
+  THINKER_NAME(T_FloorWaggle),
+  THINKER_NAME(T_CeilingWaggle),
+  THINKER_NAME(T_InterpretACS),
+  THINKER_NAME(T_MovePoly),
+  THINKER_NAME(T_RotatePoly),
+  THINKER_NAME(T_PolyDoor),
+  THINKER_NAME(dsda_UpdateQuake),
+  THINKER_NAME(dsda_UpdateAmbientSource),
+  THINKER_NAME(dsda_UpdateSideScroller),
+  THINKER_NAME(dsda_UpdateControlSideScroller),
+  THINKER_NAME(dsda_UpdateFloorScroller),
+  THINKER_NAME(dsda_UpdateControlFloorScroller),
+  THINKER_NAME(dsda_UpdateCeilingScroller),
+  THINKER_NAME(dsda_UpdateControlCeilingScroller),
+  THINKER_NAME(dsda_UpdateFloorCarryScroller),
+  THINKER_NAME(dsda_UpdateControlFloorCarryScroller),
+  THINKER_NAME(dsda_UpdateZDoomFloorScroller),
+  THINKER_NAME(dsda_UpdateZDoomCeilingScroller),
+  THINKER_NAME(dsda_UpdateThruster),
+};
+
+static const char* profile_table_names[DSDA_PROFILE_TABLE_COUNT] = {
+  [dsda_profile_thinkers] = "Thinker functions",
+  [dsda_profile_types] = "Mobj types",
+  [dsda_profile_actions] = "State actions",
+};
+
+dboolean dsda_thinker_profiling;
+
+// Thinkers and actions are hashed by function, types are indexed directly
+static profile_table_t profile_tables[DSDA_PROFILE_TABLE_COUNT];
+static int profile_tics;
+static int interval_tics;
+static int recent_tics;
+static unsigned long long interval_total;
+static unsigned long long recent_total;
+
+static unsigned int dsda_ProfileHash(actionf_t function) {
+  uintptr_t key = (uintptr_t) function;
+
+  return (unsigned int) ((key >> 4) ^ (key >> 14)) & (PROFILE_HASH_SIZE - 1);
+}
+
+static void dsda_NameThinkerEntry(profile_entry_t* entry) {
+  int i;
+
+  for (i = 0; i < sizeof(thinker_names) / sizeof(thinker_names[0]); ++i)
+    if (thinker_names[i].function == entry->function) {
+      snprintf(entry->name, sizeof(entry->name), "%s", thinker_names[i].name);
+      return;
+    }
+
+  snprintf(entry->name, sizeof(entry->name), "thinker %p", (void*) (uintptr_t) entry->function);
+}
+
+static void dsda_NameActionEntry(profile_entry_t* entry, int state) {
+  const char* name;
+
+  name = deh_ActionName(entry->function);
+
+  if (name)
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+  else
+    snprintf(entry->name, sizeof(entry->name), "action of state %d", state);
+}
+
+static profile_entry_t* dsda_FunctionProfileEntry(dsda_profile_table_t table, actionf_t function, int state) {
+  profile_table_t* t = &profile_tables[table];
+  unsigned int i;
+  int probes;
+
+  if (!t->entries) {
+    t->size = PROFILE_HASH_SIZE;
+    t->entries = Z_Calloc(t->size, sizeof(*t->entries));
+  }
+
+  i = dsda_ProfileHash(function);
+
+  for (probes = 0; probes < t->size; ++probes, i = (i + 1) & (t->size - 1)) {
+    profile_entry_t* entry = &t->entries[i];
+
+    if (entry->function == function)
+      return entry;
+
+    if (!entry->function) {
+      entry->function = function;
+
+      if (table == dsda_profile_thinkers)
+        dsda_NameThinkerEntry(entry);
+      else
+        dsda_NameActionEntry(entry, state);
+
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+static profile_entry_t* dsda_TypeProfileEntry(int type) {
+  profile_table_t* t = &profile_tables[dsda_profile_types];
+  profile_entry_t* entry;
+
+  if (type < 0)
+    return NULL;
+
+  if (type >= t->size) {
+    int old_size = t->size;
+
+    t->size = type < num_mobj_types ? num_mobj_types : type + 1;
+    t->entries = Z_Realloc(t->entries, t->size * sizeof(*t->entries));
+    memset(t->entries + old_size, 0, (t->size - old_size) * sizeof(*t->entries));
+  }
+
+  entry = &t->entries[type];
+
+  if (!entry->name[0]) {
+    if (mobjinfo[type].doomednum > 0)
+      snprintf(entry->name, sizeof(entry->name), "type %d (%d)", type, mobjinfo[type].doomednum);
+    else
+      snprintf(entry->name, sizeof(entry->name), "type %d", type);
+  }
+
+  return entry;
+}
+
+static void dsda_CountProfileEntry(profile_entry_t* entry, unsigned long long elapsed) {
+  if (!entry)
+    return;
+
+  entry->total.time += elapsed;
+  ++entry->total.calls;
+  entry->interval.time += elapsed;
+  ++entry->interval.calls;
+}
+
+void dsda_RunProfiledThinker(thinker_t* thinker) {
+  think_t function;
+  profile_entry_t* type_entry = NULL;
+  unsigned long long start, elapsed;
+
+  // The thinker may be removed by its own function, so look everything up first
+  function = thinker->function;
+
+  if (function == (think_t) P_MobjThinker || function == (think_t) P_BlasterMobjThinker)
+    type_entry = dsda_TypeProfileEntry(((mobj_t*) thinker)->type);
+
+  start = dsda_TimeNS();
+  function(thinker);
+  elapsed = dsda_TimeNS() - start;
+
+  dsda_CountProfileEntry(dsda_FunctionProfileEntry(dsda_profile_thinkers, function, 0), elapsed);
+  dsda_CountProfileEntry(type_entry, elapsed);
+
+  interval_total += elapsed;
+}
+
+void dsda_RunProfiledAction(state_t* state, mobj_t* mobj) {
+  actionf_t action;
+  int state_num;
+  unsigned long long start, elapsed;
+
+  action = state->action;
+  state_num = state - states;
+
+  start = dsda_TimeNS();
+  action(mobj);
+  elapsed = dsda_TimeNS() - start;
+
+  dsda_CountProfileEntry(dsda_FunctionProfileEntry(dsda_profile_actions, action, state_num), elapsed);
+}
+
+void dsda_EndThinkerProfileTic(void) {
+  int table, i;
+
+  ++profile_tics;
+
+  if (++interval_tics < TICRATE)
+    return;
+
+  for (table = 0; table < DSDA_PROFILE_TABLE_COUNT; ++table)
+    for (i = 0; i < profile_tables[table].size; ++i) {
+      profile_entry_t* entry = &profile_tables[table].entries[i];
+
+      entry->recent = entry->interval;
+      entry->interval.time = 0;
+      entry->interval.calls = 0;
+    }
+
+  recent_tics = interval_tics;
+  recent_total = interval_total;
+  interval_tics = 0;
+  interval_total = 0;
+}
+
+dboolean dsda_ThinkerProfiling(void) {
+  return dsda_thinker_profiling;
+}
+
+void dsda_ResetThinkerProfile(void) {
+  int table;
+
+  for (table = 0; table < DSDA_PROFILE_TABLE_COUNT; ++table) {
+    Z_Free(profile_tables[table].entries);
+    profile_tables[table].entries = NULL;
+    profile_tables[table].size = 0;
+  }
+
+  profile_tics = interval_tics = recent_tics = 0;
+  interval_total = recent_total = 0;
+}
+
+void dsda_ToggleThinkerProfile(void) {
+  dsda_thinker_profiling = !dsda_thinker_profiling;
+
+  if (dsda_thinker_profiling)
+    dsda_ResetThinkerProfile();
+}
+
+static int dsda_CompareProfileEntries(const void* a, const void* b) {
+  const profile_entry_t* x = *(const profile_entry_t* const*) a;
+  const profile_entry_t* y = *(const profile_entry_t* const*) b;
+
+  return (x->total.time < y->total.time) - (x->total.time > y->total.time);
+}
+
+static int dsda_CompareRecentProfileEntries(const void* a, const void* b) {
+  const profile_entry_t* x = *(const profile_entry_t* const*) a;
+  const profile_entry_t* y = *(const profile_entry_t* const*) b;
+
+  return (x->recent.time < y->recent.time) - (x->recent.time > y->recent.time);
+}
+
+static int dsda_SortedProfileEntries(dsda_profile_table_t table, profile_entry_t*** result,
+                                     int (*compare)(const void*, const void*)) {
+  profile_table_t* t = &profile_tables[table];
+  profile_entry_t** sorted;
+  int i, count = 0;
+
+  sorted = Z_Malloc((t->size ? t->size : 1) * sizeof(*sorted));
+
+  for (i = 0; i < t->size; ++i)
+    if (t->entries[i].total.calls)
+      sorted[count++] = &t->entries[i];
+
+  qsort(sorted, count, sizeof(*sorted), compare);
+
+  *result = sorted;
+
+  return count;
+}
+
+void dsda_PrintThinkerProfile(int limit) {
+  int table;
+
+  if (!profile_tics) {
+    lprintf(LO_INFO, "No thinker profile recorded\n");
+    return;
+  }
+
+  lprintf(LO_INFO, "Thinker profile over %d tics\n", profile_tics);
+
+  for (table = 0; table < DSDA_PROFILE_TABLE_COUNT; ++table) {
+    profile_entry_t** sorted;
+    int i, count;
+
+    count = dsda_SortedProfileEntries(table, &sorted, dsda_CompareProfileEntries);
+
+    lprintf(LO_INFO, "%s:\n", profile_table_names[table]);
+
+    for (i = 0; i < count && i < limit; ++i)
+      lprintf(LO_INFO, "  %-32s %10.3f ms %8.4f ms/tic %10u calls %8.0f ns/call\n",
+              sorted[i]->name,
+              sorted[i]->total.time / 1000000.0,
+              sorted[i]->total.time / 1000000.0 / profile_tics,
+              sorted[i]->total.calls,
+              (double) sorted[i]->total.time / sorted[i]->total.calls);
+
+    Z_Free(sorted);
+  }
+}
+
+double dsda_ThinkerProfileRecentTotal(void) {
+  if (!recent_tics)
+    return 0;
+
+  return recent_total / 1000000.0 / recent_tics;
+}
+
+int dsda_ThinkerProfileRecent(dsda_profile_table_t table, dsda_profile_line_t* lines, int limit) {
+  profile_entry_t** sorted;
+  int i, count;
+
+  if (!recent_tics)
+    return 0;
+
+  count = dsda_SortedProfileEntries(table, &sorted, dsda_CompareRecentProfileEntries);
+
+  for (i = 0; i < count && i < limit && sorted[i]->recent.calls; ++i) {
+    lines[i].name = sorted[i]->name;
+    lines[i].ms_per_tic = sorted[i]->recent.time / 1000000.0 / recent_tics;
+    lines[i].calls_per_tic = sorted[i]->recent.calls / recent_tics;
+  }
+
+  Z_Free(sorted);
+
+  return i;
+}
@@ -0,0 +1,50 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Thinker Profile
+//
+
+#ifndef __DSDA_THINKER_PROFILE__
+#define __DSDA_THINKER_PROFILE__
+
+#include "d_think.h"
+#include "info.h"
+#include "p_mobj.h"
+
+typedef enum {
+  dsda_profile_thinkers,
+  dsda_profile_types,
+  dsda_profile_actions,
+  DSDA_PROFILE_TABLE_COUNT
+} dsda_profile_table_t;
+
+typedef struct {
+  const char* name;
+  double ms_per_tic;
+  unsigned int calls_per_tic;
+} dsda_profile_line_t;
+
+extern dboolean dsda_thinker_profiling;
+
+void dsda_RunProfiledThinker(thinker_t* thinker);
+void dsda_RunProfiledAction(state_t* state, mobj_t* mobj);
+void dsda_EndThinkerProfileTic(void);
+dboolean dsda_ThinkerProfiling(void);
+void dsda_ToggleThinkerProfile(void);
+void dsda_ResetThinkerProfile(void);
+void dsda_PrintThinkerProfile(int limit);
+double dsda_ThinkerProfileRecentTotal(void);
+int dsda_ThinkerProfileRecent(dsda_profile_table_t table, dsda_profile_line_t* lines, int limit);
+
+#endif
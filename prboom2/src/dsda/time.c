@@ -71,6 +71,14 @@ unsigned long long dsda_ElapsedTime(int timer) {
          );
 }
 
+unsigned long long dsda_TimeNS(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (unsigned long long) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
 unsigned long long dsda_ElapsedTimeMS(int timer) {
   return dsda_ElapsedTime(timer) / 1000;
 }
@@ -108,7 +116,10 @@ void dsda_LimitFPS(void) {
   int allow_limit;
   int fps_limit;
 
-  allow_limit = (movement_smooth || !window_focused) && !dsda_Flag(dsda_arg_timedemo) && !dsda_Flag(dsda_arg_fastdemo);
+  allow_limit = (movement_smooth || !window_focused) &&
+                !dsda_Flag(dsda_arg_timedemo) &&
+                !dsda_Flag(dsda_arg_fastdemo) &&
+                !dsda_Flag(dsda_arg_playdemolist);
   fps_limit = window_focused ? dsda_IntConfig(dsda_config_fps_limit)
                              : dsda_IntConfig(dsda_config_background_fps_limit);
 
@@ -34,6 +34,7 @@ extern unsigned long long (*dsda_TickElapsedTime)(void);
 void dsda_StartTimer(int timer);
 unsigned long long dsda_ElapsedTime(int timer);
 unsigned long long dsda_ElapsedTimeMS(int timer);
+unsigned long long dsda_TimeNS(void);
 void dsda_PrintElapsedTime(int timer, const char* message);
 void dsda_LimitFPS(void);
 int dsda_GetTickRealTime(void);
@@ -0,0 +1,195 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Trace
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+
+#include "dsda/signal_context.h"
+#include "dsda/time.h"
+
+#include "trace.h"
+
+// Events go into a preallocated ring that any thread can append to without
+//   locking: a slot is claimed with an atomic increment and published by
+//   storing its sequence number last. When the ring wraps, the oldest events
+//   are overwritten. The ring is written as Chrome trace json on exit.
+
+#define TRACE_EVENT_LIMIT (1 << 20)
+
+typedef struct {
+  SDL_atomic_t sequence;
+  const char* name;
+  unsigned long long time;
+  SDL_threadID thread;
+  char phase;
+} trace_event_t;
+
+int dsda_tracing;
+
+static trace_event_t* trace_events;
+static SDL_atomic_t trace_next;
+static unsigned long long trace_start;
+static SDL_threadID trace_main_thread;
+static char* trace_file_name;
+
+static const struct {
+  int context;
+  const char* name;
+} trace_context_names[] = {
+  { sf_display, "display" },
+  { sf_player_view, "player_view" },
+  { sf_setup_frame, "setup_frame" },
+  { sf_clear, "clear" },
+  { sf_init_scene, "init_scene" },
+  { sf_gl_frustum, "gl_frustum" },
+  { sf_bsp_nodes, "bsp_nodes" },
+  { sf_draw_planes, "draw_planes" },
+  { sf_reset_column_buffer, "reset_column_buffer" },
+  { sf_draw_masked, "draw_masked" },
+  { sf_draw_scene, "draw_scene" },
+  { sf_status_bar, "status_bar" },
+  { sf_hud, "hud" },
+  { sf_finish_update, "finish_update" },
+};
+
+void dsda_TraceEvent(const char* name, char phase) {
+  unsigned int index;
+  trace_event_t* event;
+
+  index = (unsigned int) SDL_AtomicAdd(&trace_next, 1);
+  event = &trace_events[index & (TRACE_EVENT_LIMIT - 1)];
+
+  // Unpublish the slot while it is rewritten
+  SDL_AtomicSet(&event->sequence, 0);
+
+  event->name = name;
+  event->time = dsda_TimeNS();
+  event->thread = SDL_ThreadID();
+  event->phase = phase;
+
+  SDL_AtomicSet(&event->sequence, (int) (index + 1));
+}
+
+void dsda_TraceContext(int context, char phase) {
+  int i;
+
+  for (i = 0; i < sizeof(trace_context_names) / sizeof(trace_context_names[0]); ++i)
+    if (trace_context_names[i].context == context) {
+      dsda_TraceEvent(trace_context_names[i].name, phase);
+      return;
+    }
+}
+
+static int dsda_TraceThreadIndex(SDL_threadID* threads, int* thread_count, SDL_threadID thread) {
+  int i;
+
+  for (i = 0; i < *thread_count; ++i)
+    if (threads[i] == thread)
+      return i;
+
+  if (*thread_count == 64)
+    return 63;
+
+  threads[*thread_count] = thread;
+
+  return (*thread_count)++;
+}
+
+static void dsda_WriteTrace(void) {
+  FILE* fstream;
+  unsigned int end, index;
+  SDL_threadID threads[64];
+  int thread_count = 0;
+  int i;
+  dboolean first = true;
+
+  dsda_tracing = false;
+
+  fstream = M_OpenFile(trace_file_name, "w");
+
+  if (!fstream) {
+    lprintf(LO_WARN, "dsda_WriteTrace: failed to open %s\n", trace_file_name);
+    return;
+  }
+
+  dsda_TraceThreadIndex(threads, &thread_count, trace_main_thread);
+
+  fprintf(fstream, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  end = (unsigned int) SDL_AtomicGet(&trace_next);
+  index = end > TRACE_EVENT_LIMIT ? end - TRACE_EVENT_LIMIT : 0;
+
+  for (; index != end; ++index) {
+    trace_event_t* event = &trace_events[index & (TRACE_EVENT_LIMIT - 1)];
+
+    // Skip slots that were never finished or were already overwritten
+    if ((unsigned int) SDL_AtomicGet(&event->sequence) != index + 1)
+      continue;
+
+    fprintf(fstream, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+            first ? "" : ",\n",
+            event->name, event->phase,
+            (event->time - trace_start) / 1000.0,
+            dsda_TraceThreadIndex(threads, &thread_count, event->thread) + 1);
+
+    first = false;
+  }
+
+  for (i = 0; i < thread_count; ++i) {
+    char thread_name[16];
+
+    if (i)
+      snprintf(thread_name, sizeof(thread_name), "thread %d", i);
+    else
+      snprintf(thread_name, sizeof(thread_name), "game");
+
+    fprintf(fstream, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", i + 1, thread_name);
+
+    first = false;
+  }
+
+  fprintf(fstream, "\n]}\n");
+
+  if (fclose(fstream))
+    lprintf(LO_WARN, "dsda_WriteTrace: failed to write %s\n", trace_file_name);
+  else
+    lprintf(LO_INFO, "Trace written to %s\n", trace_file_name);
+}
+
+void dsda_InitTrace(const char* name) {
+  trace_events = calloc(TRACE_EVENT_LIMIT, sizeof(*trace_events));
+
+  if (!trace_events)
+    I_Error("dsda_InitTrace: unable to allocate the trace buffer");
+
+  trace_file_name = strdup(name);
+  trace_start = dsda_TimeNS();
+  trace_main_thread = SDL_ThreadID();
+
+  I_AtExit(dsda_WriteTrace, true, "dsda_WriteTrace", exit_priority_normal);
+
+  dsda_tracing = true;
+}
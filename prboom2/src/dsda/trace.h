@@ -0,0 +1,31 @@
+//
+// Copyright(C) 2026 by Ryan Krafnick
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Trace
+//
+
+#ifndef __DSDA_TRACE__
+#define __DSDA_TRACE__
+
+extern int dsda_tracing;
+
+// Names must be string literals (or otherwise outlive the trace)
+#define DSDA_TRACE_BEGIN(x) if (dsda_tracing) dsda_TraceEvent(x, 'B')
+#define DSDA_TRACE_END(x) if (dsda_tracing) dsda_TraceEvent(x, 'E')
+
+void dsda_InitTrace(const char* name);
+void dsda_TraceEvent(const char* name, char phase);
+void dsda_TraceContext(int context, char phase);
+
+#endif
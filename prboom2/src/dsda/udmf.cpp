@@ -19,8 +19,7 @@
 #include <vector>
 
 extern "C" {
-char *Z_StrdupLevel(const char *s);
-void *Z_MallocLevel(size_t size);
+#include "z_zone.h"
 }
 
 #include "scanner.h"
@@ -70,9 +69,9 @@ static void dsda_SkipValue(Scanner &scanner) {
 // The scanner drops the sign when scanning, and we need it back
 static char* dsda_FloatString(Scanner &scanner) {
   if (scanner.decimal >= 0)
-    return Z_StrdupLevel(scanner.string);
+    return Z_ArenaStrdup(scanner.string);
 
-  char* buffer = (char*) Z_MallocLevel(strlen(scanner.string) + 2);
+  char* buffer = (char*) Z_ArenaMalloc(strlen(scanner.string) + 2);
   buffer[0] = '-';
   buffer[1] = '\0';
   strcat(buffer, scanner.string);
@@ -103,7 +102,7 @@ static char* dsda_FloatString(Scanner &scanner) {
 
 #define SCAN_STRING(x) { scanner.MustGetToken('='); \
                          scanner.MustGetToken(TK_StringConst); \
-                         x = Z_StrdupLevel(scanner.string); \
+                         x = Z_ArenaStrdup(scanner.string); \
                          scanner.MustGetToken(';'); }
 
 #define SCAN_FLOAT_STRING(x) { scanner.MustGetToken('='); \
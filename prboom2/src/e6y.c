@@ -156,7 +156,8 @@ void ParamsMatchingCheck()
   dboolean playbacking_attempt =
     dsda_Flag(dsda_arg_playdemo) ||
     dsda_Flag(dsda_arg_timedemo) ||
-    dsda_Flag(dsda_arg_fastdemo);
+    dsda_Flag(dsda_arg_fastdemo) ||
+    dsda_Flag(dsda_arg_playdemolist);
 
   if (recording_attempt && playbacking_attempt)
     I_Error("Params are not matching: Can not being played back and recorded at the same time.");
@@ -502,9 +503,8 @@ typedef struct tmpdata_s
   char secret[200];
 } tmpdata_t;
 
-void e6y_WriteStats(void)
+void e6y_WriteStatsToStream(FILE *f)
 {
-  FILE *f;
   char str[200];
   int i, level, playerscount;
   timetable_t max;
@@ -512,14 +512,6 @@ void e6y_WriteStats(void)
   tmpdata_t *all;
   size_t allkills_len=0, allitems_len=0, allsecrets_len=0;
 
-  f = M_OpenFile("levelstat.txt", "wb");
-
-  if (f == NULL)
-  {
-    lprintf(LO_ERROR, "Unable to open levelstat.txt for writing\n");
-    return;
-  }
-
   all = Z_Malloc(sizeof(*all) * numlevels);
   memset(&max, 0, sizeof(timetable_t));
 
@@ -598,9 +590,30 @@ void e6y_WriteStats(void)
   }
 
   Z_Free(all);
+}
+
+void e6y_WriteStats(void)
+{
+  FILE *f;
+
+  f = M_OpenFile("levelstat.txt", "wb");
+
+  if (f == NULL)
+  {
+    lprintf(LO_ERROR, "Unable to open levelstat.txt for writing\n");
+    return;
+  }
+
+  e6y_WriteStatsToStream(f);
+
   fclose(f);
 }
 
+void e6y_ResetStats(void)
+{
+  numlevels = 0;
+}
+
 //--------------------------------------------------
 
 static double mouse_accelfactor;
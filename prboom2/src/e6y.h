@@ -35,6 +35,7 @@
 #define __E6Y__
 
 #include <stdarg.h>
+#include <stdio.h>
 
 #include "hu_lib.h"
 
@@ -197,6 +198,8 @@ extern int stroller;
 
 void e6y_G_DoCompleted(void);
 void e6y_WriteStats(void);
+void e6y_WriteStatsToStream(FILE *f);
+void e6y_ResetStats(void);
 
 void e6y_G_DoTeleportNewMap(void);
 void e6y_G_DoWorldDone(void);
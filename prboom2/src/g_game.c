@@ -88,6 +88,7 @@
 #include "dsda.h"
 #include "dsda/aim.h"
 #include "dsda/args.h"
+#include "dsda/benchmark.h"
 #include "dsda/brute_force.h"
 #include "dsda/build.h"
 #include "dsda/configuration.h"
@@ -108,9 +109,11 @@
 #include "dsda/options.h"
 #include "dsda/pause.h"
 #include "dsda/playback.h"
+#include "dsda/seek_index.h"
 #include "dsda/skill_info.h"
 #include "dsda/skip.h"
 #include "dsda/time.h"
+#include "dsda/trace.h"
 #include "dsda/tracker.h"
 #include "dsda/split_tracker.h"
 #include "dsda/utility.h"
@@ -1233,7 +1236,9 @@ static void G_DoLoadLevel (void)
   if (map_format.sndseq)
     SN_StopAllSequences();
 
+  DSDA_TRACE_BEGIN("level_load");
   P_SetupLevel (gameepisode, gamemap, 0, gameskill);
+  DSDA_TRACE_END("level_load");
   if (!demoplayback) // Don't switch views if playing a demo
     displayplayer = consoleplayer;    // view the guy you are playing
   gameaction = ga_nothing;
@@ -1278,6 +1283,8 @@ static void G_DoLoadLevel (void)
         first=0;
       }
   }
+
+  dsda_StartBenchmark();
 }
 
 //
@@ -1510,7 +1517,10 @@ void G_Ticker (void)
     dsda_EvaluateBruteForce();
 
   if (dsda_BuildMode())
+  {
+    dsda_EvaluateBuildSplice();
     dsda_RefreshBuildMode();
+  }
 
   if (dsda_AdvanceFrame())
   {
@@ -1533,6 +1543,9 @@ void G_Ticker (void)
     int buf = gametic % BACKUPTICS;
 
     dsda_UpdateAutoKeyFrames();
+    dsda_UpdateCheckpoints();
+    dsda_UpdateBuildTimeline();
+    dsda_UpdateSeekIndex();
     dsda_UpdateAutoSaves();
 
     if (dsda_BruteForce())
@@ -1565,6 +1578,7 @@ void G_Ticker (void)
 
     dsda_InputFlushTick();
     dsda_WatchCommand();
+    dsda_UpdateStateChecksums();
 
     // check for special buttons
     for (i = 0; i < g_maxplayers; i++)
@@ -3898,6 +3912,8 @@ void G_StartDemoPlayback(const byte *buffer, int length, int behaviour)
 
   dsda_InitDemoPlayback();
   demo_p = G_ReadDemoHeaderEx(demobuffer, demolength, RDH_SAFE);
+  dsda_LoadStateChecksums(demobuffer, demolength);
+  dsda_InitSeekIndex(demobuffer, demolength);
   dsda_AttachPlaybackStream(demo_p, demolength, behaviour);
 
   R_SmoothPlaying_Reset(NULL); // e6y
@@ -3985,6 +4001,11 @@ dboolean G_CheckDemoStatus (void)
     return false;  // killough
   }
 
+  if (dsda_AdvancePlaybackList())
+    return true;
+
+  dsda_FinishBenchmark();
+
   if (timingdemo)
   {
     int endtime = dsda_GetTickRealTime();
@@ -361,7 +361,7 @@ void RejectOverrun(unsigned int length, const byte **rejectmatrix, int totalline
   if (length < required)
   {
     // allocate a new block and copy the reject table into it; zero the rest
-    newreject = Z_MallocLevel(required);
+    newreject = Z_ArenaMalloc(required);
     *rejectmatrix = length ? memmove(newreject, *rejectmatrix, length) : newreject;
 
     // e6y
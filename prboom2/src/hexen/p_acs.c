@@ -399,7 +399,7 @@ void P_LoadACScripts(int lump)
         return;
     }
 
-    ACSInfo = Z_MallocLevel(ACScriptCount * sizeof(acsInfo_t));
+    ACSInfo = Z_ArenaMalloc(ACScriptCount * sizeof(acsInfo_t));
     memset(ACSInfo, 0, ACScriptCount * sizeof(acsInfo_t));
     for (i = 0, info = ACSInfo; i < ACScriptCount; i++, info++)
     {
@@ -431,7 +431,7 @@ void P_LoadACScripts(int lump)
 
     ACStringCount = ReadCodeInt();
     ACSAssert(ACStringCount >= 0, "negative string count %d", ACStringCount);
-    ACStrings = Z_MallocLevel(ACStringCount * sizeof(char *));
+    ACStrings = Z_ArenaMalloc(ACStringCount * sizeof(char *));
 
     for (i=0; i<ACStringCount; ++i)
     {
@@ -336,7 +336,7 @@ void P_InitLightning(void)
         LevelHasLightning = false;
         return;
     }
-    LightningLightLevels = (int *) Z_MallocLevel(secCount * sizeof(int));
+    LightningLightLevels = (int *) Z_ArenaMalloc(secCount * sizeof(int));
     NextLightningFlash = ((P_Random(pr_hexen) & 15) + 5) * 35;  // don't flash at level start
 }
 
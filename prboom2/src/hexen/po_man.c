@@ -1044,7 +1044,7 @@ void LinkPolyobj(polyobj_t * po)
                 link = &PolyBlockMap[j + i];
                 if (!(*link))
                 {               // Create a new link at the current block cell
-                    *link = Z_MallocLevel(sizeof(polyblock_t));
+                    *link = Z_ArenaMalloc(sizeof(polyblock_t));
                     (*link)->next = NULL;
                     (*link)->prev = NULL;
                     (*link)->polyobj = po;
@@ -1066,7 +1066,7 @@ void LinkPolyobj(polyobj_t * po)
                 }
                 else
                 {
-                    tempLink->next = Z_MallocLevel(sizeof(polyblock_t));
+                    tempLink->next = Z_ArenaMalloc(sizeof(polyblock_t));
                     tempLink->next->next = NULL;
                     tempLink->next->prev = tempLink;
                     tempLink->next->polyobj = po;
@@ -1140,7 +1140,7 @@ static dboolean CheckMobjBlocking(seg_t * seg, polyobj_t * po)
 void PO_ResetBlockMap(dboolean allocate)
 {
   if (allocate)
-    PolyBlockMap = Z_MallocLevel(bmapwidth * bmapheight * sizeof(polyblock_t *));
+    PolyBlockMap = Z_ArenaMalloc(bmapwidth * bmapheight * sizeof(polyblock_t *));
   memset(PolyBlockMap, 0, bmapwidth * bmapheight * sizeof(polyblock_t *));
 }
 
@@ -1240,7 +1240,7 @@ static void SpawnPolyobj(int index, int tag, dboolean crush, dboolean hurt)
             IterFindPolySegs(segs[i].v2->x, segs[i].v2->y, NULL);
 
             polyobjs[index].numsegs = PolySegCount;
-            polyobjs[index].segs = Z_MallocLevel(PolySegCount * sizeof(seg_t *));
+            polyobjs[index].segs = Z_ArenaMalloc(PolySegCount * sizeof(seg_t *));
             *(polyobjs[index].segs) = &segs[i]; // insert the first seg
             IterFindPolySegs(segs[i].v2->x, segs[i].v2->y,
                              polyobjs[index].segs + 1);
@@ -1325,7 +1325,7 @@ static void SpawnPolyobj(int index, int tag, dboolean crush, dboolean hurt)
             polyobjs[index].crush = crush;
             polyobjs[index].hurt = hurt;
             polyobjs[index].tag = tag;
-            polyobjs[index].segs = Z_MallocLevel(polyobjs[index].numsegs * sizeof(seg_t *));
+            polyobjs[index].segs = Z_ArenaMalloc(polyobjs[index].numsegs * sizeof(seg_t *));
             for (i = 0; i < polyobjs[index].numsegs; i++)
             {
                 polyobjs[index].segs[i] = polySegList[i];
@@ -1377,8 +1377,8 @@ static void TranslateToStartSpot(int tag, int originX, int originY)
             ("TranslateToStartSpot:  Anchor point located without a StartSpot point: %d\n",
              tag);
     }
-    po->originalPts = Z_MallocLevel(po->numsegs * sizeof(vertex_t));
-    po->prevPts = Z_MallocLevel(po->numsegs * sizeof(vertex_t));
+    po->originalPts = Z_ArenaMalloc(po->numsegs * sizeof(vertex_t));
+    po->prevPts = Z_ArenaMalloc(po->numsegs * sizeof(vertex_t));
     deltaX = originX - po->startSpot.x;
     deltaY = originY - po->startSpot.y;
 
@@ -1542,7 +1542,7 @@ void PO_Init(int lump)
 {
     int i;
 
-    polyobjs = Z_MallocLevel(po_NumPolyobjs * sizeof(polyobj_t));
+    polyobjs = Z_ArenaMalloc(po_NumPolyobjs * sizeof(polyobj_t));
     memset(polyobjs, 0, po_NumPolyobjs * sizeof(polyobj_t));
 
     map_loader.po_load_things(lump);
@@ -55,6 +55,8 @@
 #include "i_capture.h"
 
 #include "dsda/args.h"
+#include "dsda/brute_force.h"
+#include "dsda/playback.h"
 
 static dboolean disable_message_box;
 
@@ -127,6 +129,8 @@ void I_Error(const char *error, ...)
   vsnprintf(errmsg,sizeof(errmsg),error,argptr);
   va_end(argptr);
   lprintf(LO_ERROR, "%s\n", errmsg);
+  dsda_AbortPlaybackWorker(errmsg);
+  dsda_AbortBFWorker();
 #ifdef _WIN32
   if (!disable_message_box && !dsda_Flag(dsda_arg_nodraw) && !capturing_video) {
     I_MessageBox(errmsg, PRB_MB_OK);
@@ -164,6 +164,8 @@ cfg_def_t cfg_defs[] =
   MIGRATED_SETTING(dsda_config_render_patches_scalex),
   MIGRATED_SETTING(dsda_config_render_patches_scaley),
   MIGRATED_SETTING(dsda_config_render_stretchsky),
+  MIGRATED_SETTING(dsda_config_render_threads),
+  MIGRATED_SETTING(dsda_config_render_transposed),
   MIGRATED_SETTING(dsda_config_freelook),
 
   SETTING_HEADING("OpenGL settings"),
@@ -275,6 +277,7 @@ cfg_def_t cfg_defs[] =
   MIGRATED_SETTING(dsda_config_auto_key_frame_interval),
   MIGRATED_SETTING(dsda_config_auto_key_frame_depth),
   MIGRATED_SETTING(dsda_config_auto_key_frame_timeout),
+  MIGRATED_SETTING(dsda_config_auto_key_frame_budget),
   MIGRATED_SETTING(dsda_config_auto_save),
   MIGRATED_SETTING(dsda_config_exhud),
   MIGRATED_SETTING(dsda_config_ex_text_scale_x),
@@ -53,6 +53,7 @@
 #include "e6y.h"//e6y
 
 #include "dsda.h"
+#include "dsda/benchmark.h"
 #include "dsda/destructible.h"
 #include "dsda/excmd.h"
 #include "dsda/map_format.h"
@@ -1495,8 +1496,8 @@ void P_IterateZDoomSpecHit(mobj_t *thing, fixed_t oldx, fixed_t oldy)
     }
 }
 
-dboolean P_TryMove(mobj_t* thing,fixed_t x,fixed_t y,
-                  dboolean dropoff) // killough 3/15/98: allow dropoff as option
+static dboolean P_TryMoveInternal(mobj_t* thing,fixed_t x,fixed_t y,
+                                  dboolean dropoff) // killough 3/15/98: allow dropoff as option
 {
   fixed_t oldx;
   fixed_t oldy;
@@ -1696,6 +1697,17 @@ dboolean P_TryMove(mobj_t* thing,fixed_t x,fixed_t y,
   return true;
 }
 
+dboolean P_TryMove(mobj_t* thing,fixed_t x,fixed_t y,dboolean dropoff)
+{
+  dboolean result;
+
+  DSDA_BENCHMARK_BEGIN(dsda_bench_move);
+  result = P_TryMoveInternal(thing, x, y, dropoff);
+  DSDA_BENCHMARK_END(dsda_bench_move);
+
+  return result;
+}
+
 /*
  * killough 9/12/98:
  *
@@ -3238,7 +3250,7 @@ msecnode_t *P_GetSecnode(void)
 
   return headsecnode ?
     node = headsecnode, headsecnode = node->m_snext, node :
-  (msecnode_t *)(Z_MallocLevel(sizeof *node));
+  (msecnode_t *)(Z_ArenaMalloc(sizeof *node));
 }
 
 //
@@ -64,6 +64,7 @@
 #include "dsda/skill_info.h"
 #include "dsda/spawn_number.h"
 #include "dsda/thing_id.h"
+#include "dsda/thinker_profile.h"
 #include "dsda/tranmap.h"
 #include "dsda/utility.h"
 
@@ -122,7 +123,12 @@ dboolean P_SetMobjState(mobj_t* mobj,statenum_t state)
     // Call action functions when the state is set
 
     if (st->action)
-      st->action(mobj);
+    {
+      if (dsda_thinker_profiling)
+        dsda_RunProfiledAction(st, mobj);
+      else
+        st->action(mobj);
+    }
 
     seenstate[state] = 1 + st->nextstate;   // killough 4/9/98
 
@@ -3398,7 +3404,10 @@ dboolean Raven_P_SetMobjState(mobj_t * mobj, statenum_t state)
     mobj->frame = st->frame;
     if (st->action)
     {                           // Call action function
-        st->action(mobj);
+        if (dsda_thinker_profiling)
+            dsda_RunProfiledAction(st, mobj);
+        else
+            st->action(mobj);
     }
     return (true);
 }
@@ -3099,7 +3099,7 @@ static int P_GroupLines (void)
   }
 
   {  // allocate line tables for each sector
-    line_t **linebuffer = Z_MallocLevel(total*sizeof(line_t *));
+    line_t **linebuffer = Z_ArenaMalloc(total*sizeof(line_t *));
     // e6y: REJECT overrun emulation code
     // moved to P_LoadReject
 
@@ -42,6 +42,7 @@
 #include "g_overflow.h"
 #include "e6y.h" //e6y
 
+#include "dsda/benchmark.h"
 #include "dsda/map_format.h"
 
 /*
@@ -901,7 +902,7 @@ static dboolean P_CrossBSPNode(int bspnum)
 //
 // killough 4/20/98: cleaned up, made to use new LOS struct
 
-dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+static dboolean P_CheckSightInternal(mobj_t *t1, mobj_t *t2)
 {
   const sector_t *s1, *s2;
   int pnum;
@@ -988,6 +989,17 @@ dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
   return P_CrossBSPNode(numnodes-1);
 }
 
+dboolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+{
+  dboolean result;
+
+  DSDA_BENCHMARK_BEGIN(dsda_bench_sight);
+  result = P_CheckSightInternal(t1, t2);
+  DSDA_BENCHMARK_END(dsda_bench_sight);
+
+  return result;
+}
+
 //
 // P_CheckFov
 // Returns true if t2 is within t1's field of view.
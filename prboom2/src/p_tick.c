@@ -43,6 +43,8 @@
 #include "hexen/p_anim.h"
 
 #include "dsda.h"
+#include "dsda/benchmark.h"
+#include "dsda/thinker_profile.h"
 #include "dsda/pause.h"
 
 int leveltime;
@@ -257,12 +259,20 @@ static void P_RunThinkers (void)
     if (newthinkerpresent)
       R_ActivateThinkerInterpolations(currentthinker);
     if (currentthinker->function)
-      currentthinker->function(currentthinker);
+    {
+      if (dsda_thinker_profiling)
+        dsda_RunProfiledThinker(currentthinker);
+      else
+        currentthinker->function(currentthinker);
+    }
   }
   newthinkerpresent = false;
 
   // Dedicated thinkers
   T_MAPMusic();
+
+  if (dsda_thinker_profiling)
+    dsda_EndThinkerProfileTic();
 }
 
 void P_CleanThinkers (void)
@@ -352,7 +362,9 @@ void P_Ticker (void)
         if (playeringame[i])
           P_PlayerThink(&players[i]);
 
+    DSDA_BENCHMARK_BEGIN(dsda_bench_thinkers);
     P_RunThinkers();
+    DSDA_BENCHMARK_END(dsda_bench_thinkers);
     P_UpdateSpecials();
     P_AnimateSurfaces();
     P_RespawnSpecials();
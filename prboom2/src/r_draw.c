@@ -45,8 +45,27 @@
 #include "am_map.h"
 #include "lprintf.h"
 
+#include "SDL.h"
+
+#include "dsda/args.h"
+#include "dsda/configuration.h"
 #include "dsda/stretch.h"
 
+// SIMD drawers are chosen at startup from what the cpu reports.
+// The compiler only needs to accept the instructions for these functions.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define R_DRAW_X86_SIMD
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define R_TARGET_SSE2 __attribute__((target("sse2")))
+#define R_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define R_TARGET_SSE2
+#define R_TARGET_AVX2
+#endif
+#endif
+
 //
 // All drawing to the view buffer is accomplished in this file.
 // The other refresh files only know about ccordinates,
@@ -132,6 +151,7 @@ static int fuzzpos = 0;
 draw_vars_t drawvars = {
   NULL, // topleft
   0, // pitch
+  1, // xpitch
 };
 
 dboolean R_FullView(void)
@@ -235,6 +255,32 @@ void R_ResetColumnBuffer(void)
 
 byte *translationtables;
 
+#ifdef R_DRAW_X86_SIMD
+// Computes four texel offsets per step for power of two textures.
+// The columns land in the quad buffer, 4 bytes apart. frac advances
+//  exactly as in the scalar loop, which finishes the remainder.
+#define R_DRAWCOLUMN_SSE2_LOOP(mask) { \
+  const __m128i vmask = _mm_set1_epi32(mask); \
+  const __m128i vstep = _mm_set1_epi32((int) ((unsigned int) fracstep * 4)); \
+  __m128i vfrac = _mm_add_epi32(_mm_set1_epi32(frac), \
+                                _mm_setr_epi32(0, fracstep, \
+                                               (int) ((unsigned int) fracstep * 2), \
+                                               (int) ((unsigned int) fracstep * 3))); \
+  int spot[4]; \
+  while (count >= 4) { \
+    _mm_storeu_si128((__m128i *) spot, _mm_srli_epi32(_mm_and_si128(vfrac, vmask), FRACBITS)); \
+    dest[0] = GETCOL_DEPTH(source[spot[0]]); \
+    dest[4] = GETCOL_DEPTH(source[spot[1]]); \
+    dest[8] = GETCOL_DEPTH(source[spot[2]]); \
+    dest[12] = GETCOL_DEPTH(source[spot[3]]); \
+    dest += 16; \
+    vfrac = _mm_add_epi32(vfrac, vstep); \
+    count -= 4; \
+  } \
+  frac = _mm_cvtsi128_si32(vfrac); \
+}
+#endif
+
 #define R_DRAWCOLUMN_PIPELINE_TYPE RDC_PIPELINE_STANDARD
 #define R_DRAWCOLUMN_PIPELINE_BASE RDC_STANDARD
 
@@ -244,6 +290,16 @@ byte *translationtables;
 #define R_FLUSHQUAD_FUNCNAME R_FlushQuad
 #include "r_drawcolpipeline.inl"
 
+#ifdef R_DRAW_X86_SIMD
+#define R_DRAWCOLUMN_SSE2
+#define R_DRAWCOLUMN_FUNCNAME_COMPOSITE(postfix) R_DrawColumn ## postfix ## _SSE2
+#define R_FLUSHWHOLE_FUNCNAME R_FlushWhole
+#define R_FLUSHHEADTAIL_FUNCNAME R_FlushHT
+#define R_FLUSHQUAD_FUNCNAME R_FlushQuad
+#include "r_drawcolpipeline.inl"
+#undef R_DRAWCOLUMN_SSE2
+#endif
+
 #undef R_DRAWCOLUMN_PIPELINE_BASE
 #undef R_DRAWCOLUMN_PIPELINE_TYPE
 
@@ -268,6 +324,16 @@ byte *translationtables;
 #define R_FLUSHQUAD_FUNCNAME R_FlushQuadTL
 #include "r_drawcolpipeline.inl"
 
+#ifdef R_DRAW_X86_SIMD
+#define R_DRAWCOLUMN_SSE2
+#define R_DRAWCOLUMN_FUNCNAME_COMPOSITE(postfix) R_DrawTLColumn ## postfix ## _SSE2
+#define R_FLUSHWHOLE_FUNCNAME R_FlushWholeTL
+#define R_FLUSHHEADTAIL_FUNCNAME R_FlushHTTL
+#define R_FLUSHQUAD_FUNCNAME R_FlushQuadTL
+#include "r_drawcolpipeline.inl"
+#undef R_DRAWCOLUMN_SSE2
+#endif
+
 #undef R_DRAWCOLUMN_PIPELINE_BASE
 #undef R_DRAWCOLUMN_PIPELINE_TYPE
 
@@ -290,6 +356,16 @@ byte *translationtables;
 #define R_FLUSHQUAD_FUNCNAME R_FlushQuad
 #include "r_drawcolpipeline.inl"
 
+#ifdef R_DRAW_X86_SIMD
+#define R_DRAWCOLUMN_SSE2
+#define R_DRAWCOLUMN_FUNCNAME_COMPOSITE(postfix) R_DrawTranslatedColumn ## postfix ## _SSE2
+#define R_FLUSHWHOLE_FUNCNAME R_FlushWhole
+#define R_FLUSHHEADTAIL_FUNCNAME R_FlushHT
+#define R_FLUSHQUAD_FUNCNAME R_FlushQuad
+#include "r_drawcolpipeline.inl"
+#undef R_DRAWCOLUMN_SSE2
+#endif
+
 #undef R_DRAWCOLUMN_PIPELINE_BASE
 #undef R_DRAWCOLUMN_PIPELINE_TYPE
 
@@ -329,6 +405,23 @@ static R_DrawColumn_f drawcolumnfuncs[RDRAW_FILTER_MAXFILTERS][RDC_PIPELINE_MAXP
   },
 };
 
+#ifdef R_DRAW_X86_SIMD
+static R_DrawColumn_f drawcolumnfuncs_sse2[RDRAW_FILTER_MAXFILTERS][RDC_PIPELINE_MAXPIPELINES] = {
+  {
+    R_DrawColumn_PointUV_SSE2,
+    R_DrawTLColumn_PointUV_SSE2,
+    R_DrawTranslatedColumn_PointUV_SSE2,
+    R_DrawFuzzColumn_PointUV,
+  },
+  {
+    R_DrawColumn_PointUV_PointZ_SSE2,
+    R_DrawTLColumn_PointUV_PointZ_SSE2,
+    R_DrawTranslatedColumn_PointUV_PointZ_SSE2,
+    R_DrawFuzzColumn_PointUV_PointZ,
+  },
+};
+#endif
+
 R_DrawColumn_f R_GetDrawColumnFunc(enum column_pipeline_e type, enum draw_filter_type_e filterz) {
   R_DrawColumn_f result = drawcolumnfuncs[filterz][type];
   if (result == NULL)
@@ -431,7 +524,92 @@ void R_InitTranslationTables (void)
 //  and the inner loop has to step in texture space u and v.
 //
 
-void R_DrawSpan(draw_span_vars_t *dsvars) {
+static void R_DrawSpan_Scalar(draw_span_vars_t *dsvars) {
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  fixed_t xfrac = dsvars->xfrac;
+  fixed_t yfrac = dsvars->yfrac;
+  const fixed_t xstep = dsvars->xstep;
+  const fixed_t ystep = dsvars->ystep;
+  const byte *source = dsvars->source;
+  const byte *colormap = dsvars->colormap;
+  const int xpitch = drawvars.xpitch;
+  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1*xpitch;
+
+  while (count) {
+    const fixed_t xtemp = (xfrac >> 16) & 63;
+    const fixed_t ytemp = (yfrac >> 10) & 4032;
+    const fixed_t spot = xtemp | ytemp;
+    xfrac += xstep;
+    yfrac += ystep;
+    *dest = colormap[source[spot]];
+    dest += xpitch;
+    count--;
+  }
+}
+
+#ifdef R_DRAW_X86_SIMD
+// The texel offsets are computed for several pixels at once. The lookups
+//  themselves stay scalar - the flat and colormap are byte tables, and a
+//  gather could read past the end of the flat.
+// Steps are added with wrapping, matching the scalar loop bit for bit.
+
+R_TARGET_SSE2 static void R_DrawSpan_SSE2(draw_span_vars_t *dsvars) {
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  fixed_t xfrac = dsvars->xfrac;
+  fixed_t yfrac = dsvars->yfrac;
+  const fixed_t xstep = dsvars->xstep;
+  const fixed_t ystep = dsvars->ystep;
+  const byte *source = dsvars->source;
+  const byte *colormap = dsvars->colormap;
+  const int xpitch = drawvars.xpitch;
+  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1*xpitch;
+
+  if (count >= 4) {
+    const __m128i mx = _mm_set1_epi32(63);
+    const __m128i my = _mm_set1_epi32(4032);
+    const __m128i vxstep = _mm_set1_epi32((int) ((unsigned int) xstep * 4));
+    const __m128i vystep = _mm_set1_epi32((int) ((unsigned int) ystep * 4));
+    __m128i vx = _mm_add_epi32(_mm_set1_epi32(xfrac),
+                               _mm_setr_epi32(0, xstep,
+                                              (int) ((unsigned int) xstep * 2),
+                                              (int) ((unsigned int) xstep * 3)));
+    __m128i vy = _mm_add_epi32(_mm_set1_epi32(yfrac),
+                               _mm_setr_epi32(0, ystep,
+                                              (int) ((unsigned int) ystep * 2),
+                                              (int) ((unsigned int) ystep * 3)));
+    int spot[4];
+    int i;
+
+    while (count >= 4) {
+      _mm_storeu_si128((__m128i *) spot,
+                       _mm_or_si128(_mm_and_si128(_mm_srli_epi32(vx, 16), mx),
+                                    _mm_and_si128(_mm_srli_epi32(vy, 10), my)));
+      for (i = 0; i < 4; ++i) {
+        *dest = colormap[source[spot[i]]];
+        dest += xpitch;
+      }
+      vx = _mm_add_epi32(vx, vxstep);
+      vy = _mm_add_epi32(vy, vystep);
+      count -= 4;
+    }
+
+    xfrac = _mm_cvtsi128_si32(vx);
+    yfrac = _mm_cvtsi128_si32(vy);
+  }
+
+  while (count) {
+    const fixed_t xtemp = (xfrac >> 16) & 63;
+    const fixed_t ytemp = (yfrac >> 10) & 4032;
+    const fixed_t spot = xtemp | ytemp;
+    xfrac += xstep;
+    yfrac += ystep;
+    *dest = colormap[source[spot]];
+    dest += xpitch;
+    count--;
+  }
+}
+
+R_TARGET_AVX2 static void R_DrawSpan_AVX2(draw_span_vars_t *dsvars) {
   unsigned count = dsvars->x2 - dsvars->x1 + 1;
   fixed_t xfrac = dsvars->xfrac;
   fixed_t yfrac = dsvars->yfrac;
@@ -439,7 +617,38 @@ void R_DrawSpan(draw_span_vars_t *dsvars) {
   const fixed_t ystep = dsvars->ystep;
   const byte *source = dsvars->source;
   const byte *colormap = dsvars->colormap;
-  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1;
+  const int xpitch = drawvars.xpitch;
+  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1*xpitch;
+
+  if (count >= 8) {
+    const __m256i mx = _mm256_set1_epi32(63);
+    const __m256i my = _mm256_set1_epi32(4032);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i vxstep = _mm256_set1_epi32((int) ((unsigned int) xstep * 8));
+    const __m256i vystep = _mm256_set1_epi32((int) ((unsigned int) ystep * 8));
+    __m256i vx = _mm256_add_epi32(_mm256_set1_epi32(xfrac),
+                                  _mm256_mullo_epi32(lane, _mm256_set1_epi32(xstep)));
+    __m256i vy = _mm256_add_epi32(_mm256_set1_epi32(yfrac),
+                                  _mm256_mullo_epi32(lane, _mm256_set1_epi32(ystep)));
+    int spot[8];
+    int i;
+
+    while (count >= 8) {
+      _mm256_storeu_si256((__m256i *) spot,
+                          _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(vx, 16), mx),
+                                          _mm256_and_si256(_mm256_srli_epi32(vy, 10), my)));
+      for (i = 0; i < 8; ++i) {
+        *dest = colormap[source[spot[i]]];
+        dest += xpitch;
+      }
+      vx = _mm256_add_epi32(vx, vxstep);
+      vy = _mm256_add_epi32(vy, vystep);
+      count -= 8;
+    }
+
+    xfrac = _mm_cvtsi128_si32(_mm256_castsi256_si128(vx));
+    yfrac = _mm_cvtsi128_si32(_mm256_castsi256_si128(vy));
+  }
 
   while (count) {
     const fixed_t xtemp = (xfrac >> 16) & 63;
@@ -447,10 +656,298 @@ void R_DrawSpan(draw_span_vars_t *dsvars) {
     const fixed_t spot = xtemp | ytemp;
     xfrac += xstep;
     yfrac += ystep;
-    *dest++ = colormap[source[spot]];
+    *dest = colormap[source[spot]];
+    dest += xpitch;
     count--;
   }
 }
+#endif
+
+static void (*drawspanfunc)(draw_span_vars_t *dsvars) = R_DrawSpan_Scalar;
+
+void R_DrawSpan(draw_span_vars_t *dsvars) {
+  drawspanfunc(dsvars);
+}
+
+// With render_transposed the software view is drawn into a buffer that
+//  is stored by column, so the column flushes write contiguous memory
+//  instead of striding by the screen pitch. R_EndViewDraw copies the view
+//  to screens[0] before the hud and automap draw over it.
+
+static byte *transposed_view;
+static int transposed_pitch;
+static dboolean transposed_active;
+
+static void R_TransposeRect(int x, int y, int width, int height)
+{
+  int i, j;
+
+  for (j = y; j < y + height; ++j)
+  {
+    const byte *source = transposed_view + x * transposed_pitch + j;
+    byte *dest = screens[0].data + j * screens[0].pitch + x;
+
+    for (i = 0; i < width; ++i)
+      dest[i] = source[i * transposed_pitch];
+  }
+}
+
+static void R_TransposeView_Scalar(void)
+{
+  int x, y;
+
+  for (x = 0; x < viewwidth; x += 16)
+    for (y = 0; y < viewheight; y += 16)
+      R_TransposeRect(x, y, MIN(16, viewwidth - x), MIN(16, viewheight - y));
+}
+
+#ifdef R_DRAW_X86_SIMD
+R_TARGET_SSE2 static void R_TransposeView_SSE2(void)
+{
+  // The interleaving rounds leave output row i in vector order[i]
+  static const int order[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+  const int pitch = screens[0].pitch;
+  const int full_width = viewwidth & ~15;
+  const int full_height = viewheight & ~15;
+  int x, y, i;
+
+  for (x = 0; x < full_width; x += 16)
+  {
+    for (y = 0; y < full_height; y += 16)
+    {
+      const byte *source = transposed_view + x * transposed_pitch + y;
+      byte *dest = screens[0].data + y * pitch + x;
+      __m128i a[16], b[16];
+
+      for (i = 0; i < 16; ++i)
+        a[i] = _mm_loadu_si128((const __m128i *) (source + i * transposed_pitch));
+
+      for (i = 0; i < 8; ++i)
+      {
+        b[i] = _mm_unpacklo_epi8(a[2 * i], a[2 * i + 1]);
+        b[i + 8] = _mm_unpackhi_epi8(a[2 * i], a[2 * i + 1]);
+      }
+
+      for (i = 0; i < 8; ++i)
+      {
+        a[i] = _mm_unpacklo_epi16(b[2 * i], b[2 * i + 1]);
+        a[i + 8] = _mm_unpackhi_epi16(b[2 * i], b[2 * i + 1]);
+      }
+
+      for (i = 0; i < 8; ++i)
+      {
+        b[i] = _mm_unpacklo_epi32(a[2 * i], a[2 * i + 1]);
+        b[i + 8] = _mm_unpackhi_epi32(a[2 * i], a[2 * i + 1]);
+      }
+
+      for (i = 0; i < 8; ++i)
+      {
+        a[i] = _mm_unpacklo_epi64(b[2 * i], b[2 * i + 1]);
+        a[i + 8] = _mm_unpackhi_epi64(b[2 * i], b[2 * i + 1]);
+      }
+
+      for (i = 0; i < 16; ++i)
+        _mm_storeu_si128((__m128i *) (dest + i * pitch), a[order[i]]);
+    }
+
+    if (full_height < viewheight)
+      R_TransposeRect(x, full_height, 16, viewheight - full_height);
+  }
+
+  if (full_width < viewwidth)
+    R_TransposeRect(full_width, 0, viewwidth - full_width, viewheight);
+}
+#endif
+
+static void (*transposeviewfunc)(void) = R_TransposeView_Scalar;
+
+#ifdef R_DRAW_X86_SIMD
+// -verify_drawers draws random spans and columns with the scalar and simd
+//  drawers and compares the pixels. It uses its own random numbers and
+//  buffers, so the game state is untouched.
+
+#define VERIFY_WIDTH 320
+#define VERIFY_HEIGHT 64
+#define VERIFY_COUNT 4096
+
+static unsigned int verify_seed;
+
+static unsigned int R_VerifyRandom(void)
+{
+  verify_seed = verify_seed * 1664525 + 1013904223;
+  return verify_seed ^ (verify_seed >> 16);
+}
+
+static int R_VerifySpans(void (*simd)(draw_span_vars_t *dsvars),
+                         const byte *flat, const byte *colormap)
+{
+  byte *expected = Z_Calloc(1, VERIFY_WIDTH * VERIFY_HEIGHT);
+  byte *actual = Z_Calloc(1, VERIFY_WIDTH * VERIFY_HEIGHT);
+  int i, failures = 0;
+
+  for (i = 0; i < VERIFY_COUNT; ++i)
+  {
+    draw_span_vars_t dsvars = { 0 };
+
+    dsvars.y = R_VerifyRandom() % VERIFY_HEIGHT;
+    dsvars.x1 = R_VerifyRandom() % VERIFY_WIDTH;
+    dsvars.x2 = dsvars.x1 + R_VerifyRandom() % (VERIFY_WIDTH - dsvars.x1);
+    dsvars.xfrac = R_VerifyRandom();
+    dsvars.yfrac = R_VerifyRandom();
+    dsvars.xstep = R_VerifyRandom();
+    dsvars.ystep = R_VerifyRandom();
+    dsvars.source = flat;
+    dsvars.colormap = colormap;
+
+    // Odd spans use the column-major layout of render_transposed
+    drawvars.pitch = i & 1 ? 1 : VERIFY_WIDTH;
+    drawvars.xpitch = i & 1 ? VERIFY_HEIGHT : 1;
+
+    drawvars.topleft = expected;
+    R_DrawSpan_Scalar(&dsvars);
+    drawvars.topleft = actual;
+    simd(&dsvars);
+
+    if (memcmp(expected, actual, VERIFY_WIDTH * VERIFY_HEIGHT))
+    {
+      memcpy(actual, expected, VERIFY_WIDTH * VERIFY_HEIGHT);
+      ++failures;
+    }
+  }
+
+  Z_Free(expected);
+  Z_Free(actual);
+
+  return failures;
+}
+
+static int R_VerifyColumns(const byte *texture, const byte *colormap, const byte *translation)
+{
+  static const int texheights[] = { 128, 256, 64, 72, 8 };
+  byte *expected = Z_Malloc(VERIFY_HEIGHT * 4);
+  int filter, type, i, failures = 0;
+
+  for (filter = 0; filter < RDRAW_FILTER_MAXFILTERS; ++filter)
+    for (type = 0; type < RDC_PIPELINE_MAXPIPELINES; ++type)
+    {
+      R_DrawColumn_f scalar = drawcolumnfuncs[filter][type];
+      R_DrawColumn_f simd = drawcolumnfuncs_sse2[filter][type];
+
+      if (scalar == simd)
+        continue;
+
+      for (i = 0; i < VERIFY_COUNT; ++i)
+      {
+        draw_column_vars_t dcvars;
+
+        R_SetDefaultDrawColumnVars(&dcvars);
+        dcvars.yl = R_VerifyRandom() % VERIFY_HEIGHT;
+        dcvars.yh = dcvars.yl + R_VerifyRandom() % (VERIFY_HEIGHT - dcvars.yl);
+        // Kept small enough that the frac setup does not overflow
+        dcvars.iscale = R_VerifyRandom() % (4 << FRACBITS);
+        dcvars.texturemid = R_VerifyRandom() >> 4;
+        dcvars.texheight = texheights[R_VerifyRandom() % (sizeof(texheights) / sizeof(texheights[0]))];
+        dcvars.source = texture;
+        dcvars.colormap = colormap;
+        dcvars.translation = translation;
+
+        if (i & 1)
+        {
+          dcvars.flags = DRAW_COLUMN_ISPATCH;
+          dcvars.dy = R_VerifyRandom() % VERIFY_HEIGHT;
+        }
+
+        // Each column starts a fresh quad, so only tempbuf is written
+        memset(tempbuf, 0, VERIFY_HEIGHT * 4);
+        temp_x = 0;
+        temptype = COL_NONE;
+        scalar(&dcvars);
+        memcpy(expected, tempbuf, VERIFY_HEIGHT * 4);
+
+        memset(tempbuf, 0, VERIFY_HEIGHT * 4);
+        temp_x = 0;
+        temptype = COL_NONE;
+        simd(&dcvars);
+
+        if (memcmp(expected, tempbuf, VERIFY_HEIGHT * 4))
+          ++failures;
+      }
+    }
+
+  Z_Free(expected);
+
+  return failures;
+}
+
+static void R_VerifyDrawFunctions(void)
+{
+  const draw_vars_t saved_drawvars = drawvars;
+  byte *saved_tempbuf = tempbuf;
+  byte *texture = Z_Malloc(64 * 64 + 256);
+  int i, failures;
+
+  // The texture is large enough for both flats and the tallest column
+  for (i = 0; i < 64 * 64 + 256; ++i)
+    texture[i] = R_VerifyRandom();
+
+  tempbuf = Z_Malloc(VERIFY_HEIGHT * 4);
+
+  failures = 0;
+  if (SDL_HasSSE2())
+  {
+    failures += R_VerifyColumns(texture, texture + 1024, texture + 2048);
+    failures += R_VerifySpans(R_DrawSpan_SSE2, texture, texture + 1024);
+  }
+  if (SDL_HasAVX2())
+    failures += R_VerifySpans(R_DrawSpan_AVX2, texture, texture + 1024);
+
+  Z_Free(tempbuf);
+  Z_Free(texture);
+
+  tempbuf = saved_tempbuf;
+  temp_x = 0;
+  temptype = COL_NONE;
+  drawvars = saved_drawvars;
+
+  if (failures)
+    I_Error("R_VerifyDrawFunctions: %d simd draws differ from the scalar drawers", failures);
+
+  lprintf(LO_INFO, "R_VerifyDrawFunctions: simd drawers match the scalar drawers\n");
+}
+#endif
+
+// -nosimd keeps the scalar drawers, e.g. to compare screenshots
+static void R_SelectDrawFunctions(void)
+{
+#ifdef R_DRAW_X86_SIMD
+  static dboolean selected;
+
+  if (selected)
+    return;
+
+  selected = true;
+
+  if (dsda_Flag(dsda_arg_nosimd))
+    return;
+
+  if (dsda_Flag(dsda_arg_verify_drawers))
+    R_VerifyDrawFunctions();
+
+  if (SDL_HasSSE2())
+  {
+    memcpy(drawcolumnfuncs, drawcolumnfuncs_sse2, sizeof(drawcolumnfuncs));
+    drawspanfunc = R_DrawSpan_SSE2;
+    transposeviewfunc = R_TransposeView_SSE2;
+    lprintf(LO_DEBUG, "R_SelectDrawFunctions: using SSE2 drawers\n");
+  }
+
+  if (SDL_HasAVX2())
+  {
+    drawspanfunc = R_DrawSpan_AVX2;
+    lprintf(LO_DEBUG, "R_SelectDrawFunctions: using AVX2 span drawer\n");
+  }
+#endif
+}
 
 void R_InitBuffersRes(void)
 {
@@ -458,13 +955,27 @@ void R_InitBuffersRes(void)
 
   if (solidcol) Z_Free(solidcol);
   if (tempbuf) Z_Free(tempbuf);
+  if (transposed_view) Z_Free(transposed_view);
 
   solidcol = Z_Calloc(1, SCREENWIDTH * sizeof(*solidcol));
   tempbuf = Z_Calloc(1, (SCREENHEIGHT * 4) * sizeof(*tempbuf));
+  transposed_view = NULL;
 
   temp_x = 0;
 }
 
+static void R_SetDrawTarget(byte *topleft, int pitch, int xpitch)
+{
+  int i;
+
+  drawvars.topleft = topleft;
+  drawvars.pitch = pitch;
+  drawvars.xpitch = xpitch;
+
+  for (i=0; i<FUZZTABLE; i++)
+    fuzzoffset[i] = fuzzoffset_org[i]*pitch;
+}
+
 //
 // R_InitBuffer
 // Creats lookup tables that avoid
@@ -475,13 +986,43 @@ void R_InitBuffersRes(void)
 
 void R_InitBuffer(int width, int height)
 {
-  int i;
+  R_SetDrawTarget(screens[0].data, screens[0].pitch, 1);
 
-  drawvars.topleft = screens[0].data;
-  drawvars.pitch = screens[0].pitch;
+  R_SelectDrawFunctions();
+}
 
-  for (i=0; i<FUZZTABLE; i++)
-    fuzzoffset[i] = fuzzoffset_org[i]*screens[0].pitch;
+void R_BeginViewDraw(void)
+{
+  if (!dsda_IntConfig(dsda_config_render_transposed))
+    return;
+
+  if (!transposed_view)
+  {
+    // Columns are padded to whole blocks for the transpose
+    transposed_pitch = (SCREENHEIGHT + 15) & ~15;
+    transposed_view = Z_Calloc(SCREENWIDTH, transposed_pitch);
+  }
+
+  transposed_active = true;
+  R_SetDrawTarget(transposed_view, 1, transposed_pitch);
+}
+
+void R_EndViewDraw(void)
+{
+  if (!transposed_active)
+    return;
+
+  transposed_active = false;
+  transposeviewfunc();
+  R_SetDrawTarget(screens[0].data, screens[0].pitch, 1);
+}
+
+void R_FillViewBuffer(byte color)
+{
+  if (transposed_active)
+    memset(transposed_view, color, SCREENWIDTH * transposed_pitch);
+  else
+    V_FillRect(0, 0, 0, viewwidth, viewheight, color);
 }
 
 //
@@ -109,7 +109,8 @@ typedef struct {
 
 typedef struct {
   byte           *topleft;
-  int   pitch;
+  int   pitch;  // distance between rows
+  int   xpitch; // distance between columns
 } draw_vars_t;
 
 extern draw_vars_t drawvars;
@@ -126,6 +127,11 @@ void R_InitBuffer(int width, int height);
 
 void R_InitBuffersRes(void);
 
+// The software view may be drawn into a transposed buffer, see r_draw.c
+void R_BeginViewDraw(void);
+void R_EndViewDraw(void);
+void R_FillViewBuffer(byte color);
+
 // Initialize color translation tables, for player rendering etc.
 void R_InitTranslationTables(void);
 
@@ -42,6 +42,12 @@
 
 #define GETCOL(frac) GETCOL_DEPTH(source[(frac)>>FRACBITS])
 
+#ifdef R_DRAWCOLUMN_SSE2
+#define R_DRAWCOLUMN_TARGET R_TARGET_SSE2
+#else
+#define R_DRAWCOLUMN_TARGET
+#endif
+
 #if (R_DRAWCOLUMN_PIPELINE & RDC_TRANSLUCENT)
 #define COLTYPE (COL_TRANS)
 #elif (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
@@ -50,7 +56,7 @@
 #define COLTYPE (COL_OPAQUE)
 #endif
 
-static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
+R_DRAWCOLUMN_TARGET static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
 {
   int              count;
 
@@ -163,6 +169,9 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
 
     if (dcvars->texheight == 128) {
       #define FIXEDT_128MASK ((127<<FRACBITS)|0xffff)
+#ifdef R_DRAWCOLUMN_SSE2
+      R_DRAWCOLUMN_SSE2_LOOP(FIXEDT_128MASK);
+#endif
       while(count--) {
         *dest = GETCOL(frac & FIXEDT_128MASK);
         dest += 4;
@@ -179,6 +188,9 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
       unsigned heightmask = dcvars->texheight-1; // CPhipps - specify type
       if (! (dcvars->texheight & heightmask) ) { // power of 2 -- killough
         fixed_t fixedt_heightmask = (heightmask<<FRACBITS)|0xffff;
+#ifdef R_DRAWCOLUMN_SSE2
+        R_DRAWCOLUMN_SSE2_LOOP(fixedt_heightmask);
+#endif
         while ((count-=2)>=0) { // texture height is a power of 2 -- killough
           *dest = GETCOL(frac & fixedt_heightmask);
           dest += 4;
@@ -220,5 +232,6 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
 #undef GETCOL_DEPTH
 #undef GETCOL
 #undef COLTYPE
+#undef R_DRAWCOLUMN_TARGET
 #undef R_DRAWCOLUMN_FUNCNAME
 #undef R_DRAWCOLUMN_PIPELINE
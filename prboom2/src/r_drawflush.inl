@@ -53,7 +53,7 @@ static void R_FLUSHWHOLE_FUNCNAME(void)
    {
       yl     = tempyl[temp_x];
       source = &tempbuf[temp_x + (yl << 2)];
-      dest   = drawvars.topleft + yl*drawvars.pitch + startx + temp_x;
+      dest   = drawvars.topleft + yl*drawvars.pitch + (startx + temp_x)*drawvars.xpitch;
       count  = tempyh[temp_x] - yl + 1;
 
       while(--count >= 0)
@@ -100,7 +100,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
       if(yl < commontop)
       {
          source = &tempbuf[colnum + (yl << 2)];
-         dest   = drawvars.topleft + yl*drawvars.pitch + startx + colnum;
+         dest   = drawvars.topleft + yl*drawvars.pitch + (startx + colnum)*drawvars.xpitch;
          count  = commontop - yl;
 
          while(--count >= 0)
@@ -128,7 +128,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
       if(yh > commonbot)
       {
          source = &tempbuf[colnum + ((commonbot + 1) << 2)];
-         dest   = drawvars.topleft + (commonbot + 1)*drawvars.pitch + startx + colnum;
+         dest   = drawvars.topleft + (commonbot + 1)*drawvars.pitch + (startx + colnum)*drawvars.xpitch;
          count  = yh - commonbot;
 
          while(--count >= 0)
@@ -158,7 +158,10 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
 static void R_FLUSHQUAD_FUNCNAME(void)
 {
    byte *source = &tempbuf[commontop << 2];
-   byte *dest = drawvars.topleft + commontop*drawvars.pitch + startx;
+   byte *dest = drawvars.topleft + commontop*drawvars.pitch + startx*drawvars.xpitch;
+   const int col1 = drawvars.xpitch;
+   const int col2 = col1 * 2;
+   const int col3 = col1 * 3;
    int count;
 #if (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
    int fuzz1, fuzz2, fuzz3, fuzz4;
@@ -175,9 +178,9 @@ static void R_FLUSHQUAD_FUNCNAME(void)
    while(--count >= 0)
    {
       dest[0] = GETDESTCOLOR(dest[0], source[0]);
-      dest[1] = GETDESTCOLOR(dest[1], source[1]);
-      dest[2] = GETDESTCOLOR(dest[2], source[2]);
-      dest[3] = GETDESTCOLOR(dest[3], source[3]);
+      dest[col1] = GETDESTCOLOR(dest[col1], source[1]);
+      dest[col2] = GETDESTCOLOR(dest[col2], source[2]);
+      dest[col3] = GETDESTCOLOR(dest[col3], source[3]);
       source += 4 * sizeof(byte);
       dest += drawvars.pitch * sizeof(byte);
    }
@@ -185,9 +188,9 @@ static void R_FLUSHQUAD_FUNCNAME(void)
    while(--count >= 0)
    {
       dest[0] = GETDESTCOLOR(dest[0 + fuzzoffset[fuzz1]]);
-      dest[1] = GETDESTCOLOR(dest[1 + fuzzoffset[fuzz2]]);
-      dest[2] = GETDESTCOLOR(dest[2 + fuzzoffset[fuzz3]]);
-      dest[3] = GETDESTCOLOR(dest[3 + fuzzoffset[fuzz4]]);
+      dest[col1] = GETDESTCOLOR(dest[col1 + fuzzoffset[fuzz2]]);
+      dest[col2] = GETDESTCOLOR(dest[col2 + fuzzoffset[fuzz3]]);
+      dest[col3] = GETDESTCOLOR(dest[col3 + fuzzoffset[fuzz4]]);
       fuzz1 = (fuzz1 + 1) % FUZZTABLE;
       fuzz2 = (fuzz2 + 1) % FUZZTABLE;
       fuzz3 = (fuzz3 + 1) % FUZZTABLE;
@@ -196,7 +199,7 @@ static void R_FLUSHQUAD_FUNCNAME(void)
       dest += drawvars.pitch * sizeof(byte);
    }
 #else
-   if ((sizeof(int) == 4) && (((intptr_t)source % 4) == 0) && (((intptr_t)dest % 4) == 0)) {
+   if ((sizeof(int) == 4) && col1 == 1 && (((intptr_t)source % 4) == 0) && (((intptr_t)dest % 4) == 0)) {
       while(--count >= 0)
       {
          *(int *)dest = *(int *)source;
@@ -207,9 +210,9 @@ static void R_FLUSHQUAD_FUNCNAME(void)
       while(--count >= 0)
       {
          dest[0] = source[0];
-         dest[1] = source[1];
-         dest[2] = source[2];
-         dest[3] = source[3];
+         dest[col1] = source[1];
+         dest[col2] = source[2];
+         dest[col3] = source[3];
          source += 4 * sizeof(byte);
          dest += drawvars.pitch * sizeof(byte);
       }
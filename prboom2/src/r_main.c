@@ -61,6 +61,7 @@
 #include "e6y.h"//e6y
 #include "xs_Float.h"
 
+#include "dsda/benchmark.h"
 #include "dsda/configuration.h"
 #include "dsda/exhud.h"
 #include "dsda/map_format.h"
@@ -995,10 +996,12 @@ static void R_InitDrawScene(void)
       gld_StartDrawScene();
     }
   } else {
+    R_BeginViewDraw();
+
     if (dsda_IntConfig(dsda_config_flashing_hom))
     { // killough 2/10/98: add flashing red HOM indicators
       unsigned char color=(gametic % 20) < 9 ? 0xb0 : 0;
-      V_FillRect(0, 0, 0, viewwidth, viewheight, color);
+      R_FillViewBuffer(color);
       R_DrawViewBorder();
     }
 
@@ -1068,7 +1071,9 @@ void R_RenderPlayerView (player_t* player)
   }
 
   DSDA_ADD_CONTEXT(sf_bsp_nodes);
+  DSDA_BENCHMARK_BEGIN(dsda_bench_bsp);
   R_RenderBSPNodes();
+  DSDA_BENCHMARK_END(dsda_bench_bsp);
   DSDA_REMOVE_CONTEXT(sf_bsp_nodes);
 
   FakeNetUpdate();
@@ -1076,7 +1081,9 @@ void R_RenderPlayerView (player_t* player)
   if (V_IsSoftwareMode())
   {
     DSDA_ADD_CONTEXT(sf_draw_planes);
+    DSDA_BENCHMARK_BEGIN(dsda_bench_planes);
     R_DrawPlanes();
+    DSDA_BENCHMARK_END(dsda_bench_planes);
     DSDA_REMOVE_CONTEXT(sf_draw_planes);
   }
 
@@ -1088,9 +1095,13 @@ void R_RenderPlayerView (player_t* player)
 
   if (V_IsSoftwareMode()) {
     DSDA_ADD_CONTEXT(sf_draw_masked);
+    DSDA_BENCHMARK_BEGIN(dsda_bench_masked);
     R_DrawMasked ();
     R_ResetColumnBuffer();
+    DSDA_BENCHMARK_END(dsda_bench_masked);
     DSDA_REMOVE_CONTEXT(sf_draw_masked);
+
+    R_EndViewDraw();
   }
 
   FakeNetUpdate();
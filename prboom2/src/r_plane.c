@@ -59,10 +59,15 @@
 #include "r_plane.h"
 #include "r_main.h"
 #include "v_video.h"
+#include "i_system.h"
 #include "lprintf.h"
 
+#include "SDL.h"
+
+#include "dsda/configuration.h"
 #include "dsda/map_format.h"
 #include "dsda/render_stats.h"
+#include "dsda/trace.h"
 
 int Sky1Texture;
 int Sky2Texture;
@@ -112,8 +117,47 @@ static fixed_t *cachedheight = NULL;
 fixed_t *yslope = NULL;
 fixed_t *distscale = NULL;
 
+// Flats can be drawn by several threads, each owning a vertical strip of
+//  the view. Only the pixels inside the strip are written, and spans keep
+//  the texture coordinates they have when drawn in one piece. Visplanes
+//  never share pixels, so the result matches the single threaded renderer
+//  exactly.
+// Unscaled planes are walked from the strip edge. Scaled planes round their
+//  coordinates after the span start is applied, so those are still walked
+//  from the start of the plane in every strip.
+// Skies go through the column drawers, which are not thread safe, so they
+//  stay on the main thread.
+// This is the only threaded part of the renderer. BSP traversal, walls and
+//  sprites share the clipping arrays and stay single threaded. Compare the
+//  "planes" section of -benchmark runs with render_threads 1 and N.
+
+#define MAX_PLANE_STRIPS 16
+
+typedef struct {
+  int x1, x2;
+  int *spanstart;
+  SDL_Thread *thread;
+  SDL_sem *start;
+} plane_strip_t;
+
+typedef struct {
+  visplane_t *pl;
+  draw_span_vars_t dsvars;
+} flat_plane_t;
+
+static plane_strip_t plane_strips[MAX_PLANE_STRIPS];
+static int plane_thread_count;
+static SDL_sem *plane_strips_done;
+static volatile dboolean plane_threads_quit;
+
+static flat_plane_t *flat_planes;
+static int flat_plane_count;
+static int flat_plane_capacity;
+
 void R_InitPlanesRes(void)
 {
+  int i;
+
   if (floorclip) Z_Free(floorclip);
   if (ceilingclip) Z_Free(ceilingclip);
   if (spanstart) Z_Free(spanstart);
@@ -131,6 +175,16 @@ void R_InitPlanesRes(void)
 
   yslope = Z_Calloc(1, SCREENHEIGHT * sizeof(*yslope));
   distscale = Z_Calloc(1, SCREENWIDTH * sizeof(*distscale));
+
+  // The first strip belongs to the main thread
+  plane_strips[0].spanstart = spanstart;
+
+  for (i = 1; i < MAX_PLANE_STRIPS; i++)
+    if (plane_strips[i].spanstart)
+    {
+      Z_Free(plane_strips[i].spanstart);
+      plane_strips[i].spanstart = Z_Calloc(1, SCREENHEIGHT * sizeof(*spanstart));
+    }
 }
 
 void R_InitVisplanesRes(void)
@@ -158,12 +212,16 @@ void R_InitPlanes (void)
 // R_MapPlane
 //
 
-static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
+static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars,
+                       const plane_strip_t *strip)
 {
   int64_t den;
   fixed_t distance;
   unsigned index;
 
+  if (x2 < strip->x1 || x1 > strip->x2)
+    return;
+
 #ifdef RANGECHECK
   if (x2 < x1 || x1<0 || x2>=viewwidth || (unsigned)y>(unsigned)viewheight)
     I_Error ("R_MapPlane: %i, %i at %i",x1,x2,y);
@@ -209,6 +267,19 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
     dsvars->z = 0;
   }
 
+  // Step to the strip edge exactly as R_DrawSpan would have
+  if (x1 < strip->x1)
+  {
+    unsigned int skip = strip->x1 - x1;
+
+    dsvars->xfrac = (fixed_t) ((unsigned int) dsvars->xfrac + skip * (unsigned int) dsvars->xstep);
+    dsvars->yfrac = (fixed_t) ((unsigned int) dsvars->yfrac + skip * (unsigned int) dsvars->ystep);
+    x1 = strip->x1;
+  }
+
+  if (x2 > strip->x2)
+    x2 = strip->x2;
+
   dsvars->y = y;
   dsvars->x1 = x1;
   dsvars->x2 = x2;
@@ -377,12 +448,14 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop)
 
 static void R_MakeSpans(int x, unsigned int t1, unsigned int b1,
                         unsigned int t2, unsigned int b2,
-                        draw_span_vars_t *dsvars)
+                        draw_span_vars_t *dsvars, const plane_strip_t *strip)
 {
+  int *spanstart = strip->spanstart;
+
   for (; t1 < t2 && t1 <= b1; t1++)
-    R_MapPlane(t1, spanstart[t1], x-1, dsvars);
+    R_MapPlane(t1, spanstart[t1], x-1, dsvars, strip);
   for (; b1 > b2 && b1 >= t1; b1--)
-    R_MapPlane(b1, spanstart[b1] ,x-1, dsvars);
+    R_MapPlane(b1, spanstart[b1] ,x-1, dsvars, strip);
   while (t2 < t1 && t2 <= b2)
     spanstart[t2++] = x;
   while (b2 > b1 && b2 >= t2)
@@ -411,358 +484,460 @@ const rpatch_t *R_HackedSkyPatch(texture_t *texture)
 
 // New function, by Lee Killough
 
-static void R_DoDrawPlane(visplane_t *pl)
+static void R_DrawSkyPlane(visplane_t *pl)
 {
   register int x;
   draw_column_vars_t dcvars;
   R_DrawColumn_f colfunc = R_GetDrawColumnFunc(RDC_PIPELINE_STANDARD, RDRAW_FILTER_POINT);
+  int texture;
+  const rpatch_t *tex_patch;
+  angle_t an, flip;
 
   R_SetDefaultDrawColumnVars(&dcvars);
 
-  if (pl->minx <= pl->maxx) {
-    // hexen_note: Skies
-    // if (pl->picnum == skyflatnum)
-    // {                       // Sky flat
-    //     #define SKYTEXTUREMIDSHIFTED 200
-    //
-    //     byte *source;
-    //     byte *source2;
-    //     int offset;
-    //     int skyTexture;
-    //     int offset2;
-    //     int skyTexture2;
-    //
-    //     if (DoubleSky)
-    //     {                   // Render 2 layers, sky 1 in front
-    //         offset = Sky1ColumnOffset >> 16;
-    //         skyTexture = texturetranslation[Sky1Texture];
-    //         offset2 = Sky2ColumnOffset >> 16;
-    //         skyTexture2 = texturetranslation[Sky2Texture];
-    //         for (x = pl->minx; x <= pl->maxx; x++)
-    //         {
-    //             dc_yl = pl->top[x];
-    //             dc_yh = pl->bottom[x];
-    //             if (dc_yl <= dc_yh)
-    //             {
-    //                 count = dc_yh - dc_yl;
-    //                 if (count < 0)
-    //                 {
-    //                     return;
-    //                 }
-    //                 angle = (viewangle + xtoviewangle[x])
-    //                     >> ANGLETOSKYSHIFT;
-    //                 source = R_GetColumn(skyTexture, angle + offset);
-    //                 source2 = R_GetColumn(skyTexture2, angle + offset2);
-    //                 dest = ylookup[dc_yl] + columnofs[x];
-    //                 frac = SKYTEXTUREMIDSHIFTED * FRACUNIT + (dc_yl - centery) * fracstep;
-    //                 do
-    //                 {
-    //                     if (source[frac >> FRACBITS])
-    //                     {
-    //                         *dest = source[frac >> FRACBITS];
-    //                         frac += fracstep;
-    //                     }
-    //                     else
-    //                     {
-    //                         *dest = source2[frac >> FRACBITS];
-    //                         frac += fracstep;
-    //                     }
-    //                     dest += SCREENWIDTH;
-    //                 }
-    //                 while (count--);
-    //             }
-    //         }
-    //         continue;       // Next visplane
-    //     }
-    //     else
-    //     {                   // Render single layer
-    //         if (pl->special == 200)
-    //         {               // Use sky 2
-    //             offset = Sky2ColumnOffset >> 16;
-    //             skyTexture = texturetranslation[Sky2Texture];
-    //         }
-    //         else
-    //         {               // Use sky 1
-    //             offset = Sky1ColumnOffset >> 16;
-    //             skyTexture = texturetranslation[Sky1Texture];
-    //         }
-    //         for (x = pl->minx; x <= pl->maxx; x++)
-    //         {
-    //             dc_yl = pl->top[x];
-    //             dc_yh = pl->bottom[x];
-    //             if (dc_yl <= dc_yh)
-    //             {
-    //                 count = dc_yh - dc_yl;
-    //                 if (count < 0)
-    //                 {
-    //                     return;
-    //                 }
-    //                 angle = (viewangle + xtoviewangle[x])
-    //                     >> ANGLETOSKYSHIFT;
-    //                 source = R_GetColumn(skyTexture, angle + offset);
-    //                 dest = ylookup[dc_yl] + columnofs[x];
-    //                 frac = SKYTEXTUREMIDSHIFTED * FRACUNIT + (dc_yl - centery) * fracstep;
-    //                 do
-    //                 {
-    //                     *dest = source[frac >> FRACBITS];
-    //                     dest += SCREENWIDTH;
-    //                     frac += fracstep;
-    //                 }
-    //                 while (count--);
-    //             }
-    //         }
-    //         continue;       // Next visplane
-    //     }
-    // }
-
-    if (pl->picnum == skyflatnum || pl->picnum & PL_SKYFLAT) { // sky flat
-      int texture;
-      const rpatch_t *tex_patch;
-      angle_t an, flip;
-
-      // killough 10/98: allow skies to come from sidedefs.
-      // Allows scrolling and/or animated skies, as well as
-      // arbitrary multiple skies per level without having
-      // to use info lumps.
-
-      an = viewangle;
-
-      if (pl->picnum & PL_SKYFLAT_LINE)
-      {
-        // Sky Linedef
-        const line_t *l = &lines[pl->picnum & ~PL_SKYFLAT_LINE];
-
-        // Sky transferred from first sidedef
-        const side_t *s = *l->sidenum + sides;
+  // hexen_note: Skies
+  // if (pl->picnum == skyflatnum)
+  // {                       // Sky flat
+  //     #define SKYTEXTUREMIDSHIFTED 200
+  //
+  //     byte *source;
+  //     byte *source2;
+  //     int offset;
+  //     int skyTexture;
+  //     int offset2;
+  //     int skyTexture2;
+  //
+  //     if (DoubleSky)
+  //     {                   // Render 2 layers, sky 1 in front
+  //         offset = Sky1ColumnOffset >> 16;
+  //         skyTexture = texturetranslation[Sky1Texture];
+  //         offset2 = Sky2ColumnOffset >> 16;
+  //         skyTexture2 = texturetranslation[Sky2Texture];
+  //         for (x = pl->minx; x <= pl->maxx; x++)
+  //         {
+  //             dc_yl = pl->top[x];
+  //             dc_yh = pl->bottom[x];
+  //             if (dc_yl <= dc_yh)
+  //             {
+  //                 count = dc_yh - dc_yl;
+  //                 if (count < 0)
+  //                 {
+  //                     return;
+  //                 }
+  //                 angle = (viewangle + xtoviewangle[x])
+  //                     >> ANGLETOSKYSHIFT;
+  //                 source = R_GetColumn(skyTexture, angle + offset);
+  //                 source2 = R_GetColumn(skyTexture2, angle + offset2);
+  //                 dest = ylookup[dc_yl] + columnofs[x];
+  //                 frac = SKYTEXTUREMIDSHIFTED * FRACUNIT + (dc_yl - centery) * fracstep;
+  //                 do
+  //                 {
+  //                     if (source[frac >> FRACBITS])
+  //                     {
+  //                         *dest = source[frac >> FRACBITS];
+  //                         frac += fracstep;
+  //                     }
+  //                     else
+  //                     {
+  //                         *dest = source2[frac >> FRACBITS];
+  //                         frac += fracstep;
+  //                     }
+  //                     dest += SCREENWIDTH;
+  //                 }
+  //                 while (count--);
+  //             }
+  //         }
+  //         continue;       // Next visplane
+  //     }
+  //     else
+  //     {                   // Render single layer
+  //         if (pl->special == 200)
+  //         {               // Use sky 2
+  //             offset = Sky2ColumnOffset >> 16;
+  //             skyTexture = texturetranslation[Sky2Texture];
+  //         }
+  //         else
+  //         {               // Use sky 1
+  //             offset = Sky1ColumnOffset >> 16;
+  //             skyTexture = texturetranslation[Sky1Texture];
+  //         }
+  //         for (x = pl->minx; x <= pl->maxx; x++)
+  //         {
+  //             dc_yl = pl->top[x];
+  //             dc_yh = pl->bottom[x];
+  //             if (dc_yl <= dc_yh)
+  //             {
+  //                 count = dc_yh - dc_yl;
+  //                 if (count < 0)
+  //                 {
+  //                     return;
+  //                 }
+  //                 angle = (viewangle + xtoviewangle[x])
+  //                     >> ANGLETOSKYSHIFT;
+  //                 source = R_GetColumn(skyTexture, angle + offset);
+  //                 dest = ylookup[dc_yl] + columnofs[x];
+  //                 frac = SKYTEXTUREMIDSHIFTED * FRACUNIT + (dc_yl - centery) * fracstep;
+  //                 do
+  //                 {
+  //                     *dest = source[frac >> FRACBITS];
+  //                     dest += SCREENWIDTH;
+  //                     frac += fracstep;
+  //                 }
+  //                 while (count--);
+  //             }
+  //         }
+  //         continue;       // Next visplane
+  //     }
+  // }
+
+  // killough 10/98: allow skies to come from sidedefs.
+  // Allows scrolling and/or animated skies, as well as
+  // arbitrary multiple skies per level without having
+  // to use info lumps.
+
+  an = viewangle;
+
+  if (pl->picnum & PL_SKYFLAT_LINE)
+  {
+    // Sky Linedef
+    const line_t *l = &lines[pl->picnum & ~PL_SKYFLAT_LINE];
 
-        // Texture comes from upper texture of reference sidedef
-        texture = texturetranslation[s->toptexture];
+    // Sky transferred from first sidedef
+    const side_t *s = *l->sidenum + sides;
 
-        // Horizontal offset is turned into an angle offset,
-        // to allow sky rotation as well as careful positioning.
-        // However, the offset is scaled very small, so that it
-        // allows a long-period of sky rotation.
+    // Texture comes from upper texture of reference sidedef
+    texture = texturetranslation[s->toptexture];
 
-        an += s->textureoffset;
+    // Horizontal offset is turned into an angle offset,
+    // to allow sky rotation as well as careful positioning.
+    // However, the offset is scaled very small, so that it
+    // allows a long-period of sky rotation.
 
-        // Vertical offset allows careful sky positioning.
+    an += s->textureoffset;
 
-        dcvars.texturemid = s->rowoffset - 28*FRACUNIT;
+    // Vertical offset allows careful sky positioning.
 
-        // We sometimes flip the picture horizontally.
-        //
-        // Doom always flipped the picture, so we make it optional,
-        // to make it easier to use the new feature, while to still
-        // allow old sky textures to be used.
+    dcvars.texturemid = s->rowoffset - 28*FRACUNIT;
 
-        flip = l->special==272 ? 0u : ~0u;
+    // We sometimes flip the picture horizontally.
+    //
+    // Doom always flipped the picture, so we make it optional,
+    // to make it easier to use the new feature, while to still
+    // allow old sky textures to be used.
 
-        if (skystretch)
-        {
-          int skyheight = textureheight[texture]>>FRACBITS;
-          dcvars.texturemid = (int)((int64_t)dcvars.texturemid * skyheight / SKYSTRETCH_HEIGHT);
-        }
-      }
-      else if (pl->picnum & PL_SKYFLAT_SECTOR)
-      {
-        dcvars.texturemid = skytexturemid;
-        texture = pl->picnum & ~PL_SKYFLAT_SECTOR;
-        flip = 0;
-      }
-      else
-      {    // Normal Doom sky, only one allowed per level
-        dcvars.texturemid = skytexturemid;    // Default y-offset
-        texture = skytexture;             // Default texture
-        flip = 0;                         // Doom flips it
-      }
+    flip = l->special==272 ? 0u : ~0u;
 
-      /* Sky is always drawn full bright, i.e. colormaps[0] is used.
-       * Because of this hack, sky is not affected by INVUL inverse mapping.
-       * Until Boom fixed this. Compat option added in MBF. */
+    if (skystretch)
+    {
+      int skyheight = textureheight[texture]>>FRACBITS;
+      dcvars.texturemid = (int)((int64_t)dcvars.texturemid * skyheight / SKYSTRETCH_HEIGHT);
+    }
+  }
+  else if (pl->picnum & PL_SKYFLAT_SECTOR)
+  {
+    dcvars.texturemid = skytexturemid;
+    texture = pl->picnum & ~PL_SKYFLAT_SECTOR;
+    flip = 0;
+  }
+  else
+  {    // Normal Doom sky, only one allowed per level
+    dcvars.texturemid = skytexturemid;    // Default y-offset
+    texture = skytexture;             // Default texture
+    flip = 0;                         // Doom flips it
+  }
 
-      if (comp[comp_skymap] || !(dcvars.colormap = fixedcolormap))
-        dcvars.colormap = fullcolormap;          // killough 3/20/98
+  /* Sky is always drawn full bright, i.e. colormaps[0] is used.
+   * Because of this hack, sky is not affected by INVUL inverse mapping.
+   * Until Boom fixed this. Compat option added in MBF. */
 
-      //dcvars.texturemid = skytexturemid;
-      dcvars.texheight = textureheight[texture]>>FRACBITS; // killough
+  if (comp[comp_skymap] || !(dcvars.colormap = fixedcolormap))
+    dcvars.colormap = fullcolormap;          // killough 3/20/98
 
-      // proff 09/21/98: Changed for high-res
+  //dcvars.texturemid = skytexturemid;
+  dcvars.texheight = textureheight[texture]>>FRACBITS; // killough
 
-      // e6y
-      // disable sky texture scaling if status bar is used
-      // old code: dcvars.iscale = FRACUNIT*200/viewheight;
-      dcvars.iscale = skyiscale;
+  // proff 09/21/98: Changed for high-res
 
-      {
-        const rpatch_t *patch;
+  // e6y
+  // disable sky texture scaling if status bar is used
+  // old code: dcvars.iscale = FRACUNIT*200/viewheight;
+  dcvars.iscale = skyiscale;
 
-        patch = R_HackedSkyPatch(textures[texture]);
+  {
+    const rpatch_t *patch;
 
-        if (patch)
-        {
-          dcvars.texheight = patch->height;
-          dcvars.texturemid = 200 << FRACBITS;
-          dcvars.iscale = (200 << FRACBITS) / SCREENHEIGHT;
-
-          for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
-            if ((dcvars.yl = pl->top[x]) != SHRT_MAX && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
-            {
-              dcvars.source = R_GetPatchColumn(patch, (an + xtoviewangle[x]) >> ANGLETOSKYSHIFT)->pixels;
-              dcvars.prevsource = R_GetPatchColumn(patch, (an + xtoviewangle[x-1]) >> ANGLETOSKYSHIFT)->pixels;
-              dcvars.nextsource = R_GetPatchColumn(patch, (an + xtoviewangle[x+1]) >> ANGLETOSKYSHIFT)->pixels;
-              colfunc(&dcvars);
-            }
-
-          return;
-        }
-      }
+    patch = R_HackedSkyPatch(textures[texture]);
 
-      tex_patch = R_TextureCompositePatchByNum(texture);
+    if (patch)
+    {
+      dcvars.texheight = patch->height;
+      dcvars.texturemid = 200 << FRACBITS;
+      dcvars.iscale = (200 << FRACBITS) / SCREENHEIGHT;
 
-      // killough 10/98: Use sky scrolling offset, and possibly flip picture
       for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
         if ((dcvars.yl = pl->top[x]) != SHRT_MAX && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
         {
-          dcvars.source = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x])^flip) >> ANGLETOSKYSHIFT);
-          dcvars.prevsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x-1])^flip) >> ANGLETOSKYSHIFT);
-          dcvars.nextsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x+1])^flip) >> ANGLETOSKYSHIFT);
+          dcvars.source = R_GetPatchColumn(patch, (an + xtoviewangle[x]) >> ANGLETOSKYSHIFT)->pixels;
+          dcvars.prevsource = R_GetPatchColumn(patch, (an + xtoviewangle[x-1]) >> ANGLETOSKYSHIFT)->pixels;
+          dcvars.nextsource = R_GetPatchColumn(patch, (an + xtoviewangle[x+1]) >> ANGLETOSKYSHIFT)->pixels;
           colfunc(&dcvars);
         }
+
+      return;
     }
-    else {     // regular flat
+  }
 
-      int stop, light;
-      draw_span_vars_t dsvars;
+  tex_patch = R_TextureCompositePatchByNum(texture);
 
-      dsvars.source = W_LumpByNum(firstflat + flattranslation[pl->picnum]);
-      dsvars.xoffs = pl->xoffs;
-      dsvars.yoffs = pl->yoffs;
-      dsvars.xscale = pl->xscale;
-      dsvars.yscale = pl->yscale;
+  // killough 10/98: Use sky scrolling offset, and possibly flip picture
+  for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
+    if ((dcvars.yl = pl->top[x]) != SHRT_MAX && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
+    {
+      dcvars.source = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x])^flip) >> ANGLETOSKYSHIFT);
+      dcvars.prevsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x-1])^flip) >> ANGLETOSKYSHIFT);
+      dcvars.nextsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x+1])^flip) >> ANGLETOSKYSHIFT);
+      colfunc(&dcvars);
+    }
+}
 
-      if (pl->rotation)
-      {
-        fixed_t rotation_cos, rotation_sin;
+// Everything the span drawer needs is resolved on the main thread,
+//  since looking up the flat may touch the lump cache.
+static void R_SetupFlatPlane(visplane_t *pl, draw_span_vars_t *dsvars)
+{
+  int stop, light;
 
-        rotation_cos = finecosine[pl->rotation >> ANGLETOFINESHIFT];
-        rotation_sin = finesine[pl->rotation >> ANGLETOFINESHIFT];
+  dsvars->source = W_LumpByNum(firstflat + flattranslation[pl->picnum]);
+  dsvars->xoffs = pl->xoffs;
+  dsvars->yoffs = pl->yoffs;
+  dsvars->xscale = pl->xscale;
+  dsvars->yscale = pl->yscale;
 
-        dsvars.xoffs += FixedMul(rotation_cos, viewx) - FixedMul(rotation_sin, viewy);
-        dsvars.yoffs -= FixedMul(rotation_sin, viewx) + FixedMul(rotation_cos, viewy);
-        dsvars.sine = finesine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
-        dsvars.cosine = finecosine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
-      }
-      else
-      {
-        dsvars.xoffs += viewx;
-        dsvars.yoffs -= viewy;
-        dsvars.sine = viewsin;
-        dsvars.cosine = viewcos;
-      }
+  if (pl->rotation)
+  {
+    fixed_t rotation_cos, rotation_sin;
 
-      if (map_format.hexen)
-      {
-        int scrollOffset = leveltime >> 1 & 63;
-
-        switch (pl->special)
-        {                       // Handle scrolling flats
-          case 201:
-          case 202:
-          case 203:          // Scroll_North_xxx
-            dsvars.source = dsvars.source + ((scrollOffset
-                                       << (pl->special - 201) & 63) << 6);
-            break;
-          case 204:
-          case 205:
-          case 206:          // Scroll_East_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 204) & 63);
-            break;
-          case 207:
-          case 208:
-          case 209:          // Scroll_South_xxx
-            dsvars.source = dsvars.source + (((63 - scrollOffset)
-                                       << (pl->special - 207) & 63) << 6);
-            break;
-          case 210:
-          case 211:
-          case 212:          // Scroll_West_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 210) & 63);
-            break;
-          case 213:
-          case 214:
-          case 215:          // Scroll_NorthWest_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 213) & 63) +
-                ((scrollOffset << (pl->special - 213) & 63) << 6);
-            break;
-          case 216:
-          case 217:
-          case 218:          // Scroll_NorthEast_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 216) & 63) +
-                ((scrollOffset << (pl->special - 216) & 63) << 6);
-            break;
-          case 219:
-          case 220:
-          case 221:          // Scroll_SouthEast_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 219) & 63) +
-                (((63 - scrollOffset) << (pl->special - 219) & 63) << 6);
-            break;
-          case 222:
-          case 223:
-          case 224:          // Scroll_SouthWest_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 222) & 63) +
-                (((63 - scrollOffset) << (pl->special - 222) & 63) << 6);
-            break;
-          default:
-            break;
-        }
-      }
-      else if (heretic)
-      {
-        switch (pl->special)
-        {
-          case 20:
-          case 21:
-          case 22:
-          case 23:
-          case 24:           // Scroll_East
-            dsvars.source = dsvars.source +
-              ((63 - ((leveltime >> 1) & 63)) << (pl->special - 20) & 63);
-            break;
-          case 4:            // Scroll_EastLavaDamage
-            dsvars.source = dsvars.source +
-              (((63 - ((leveltime >> 1) & 63)) << 3) & 63);
-            break;
-        }
-      }
+    rotation_cos = finecosine[pl->rotation >> ANGLETOFINESHIFT];
+    rotation_sin = finesine[pl->rotation >> ANGLETOFINESHIFT];
 
-      dsvars.planeheight = D_abs(pl->height-viewz);
+    dsvars->xoffs += FixedMul(rotation_cos, viewx) - FixedMul(rotation_sin, viewy);
+    dsvars->yoffs -= FixedMul(rotation_sin, viewx) + FixedMul(rotation_cos, viewy);
+    dsvars->sine = finesine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
+    dsvars->cosine = finecosine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
+  }
+  else
+  {
+    dsvars->xoffs += viewx;
+    dsvars->yoffs -= viewy;
+    dsvars->sine = viewsin;
+    dsvars->cosine = viewcos;
+  }
 
-      // SoM 10/19/02: deep water colormap fix
-      if(fixedcolormap)
-        light = (255  >> LIGHTSEGSHIFT);
-      else
-        light = (pl->lightlevel >> LIGHTSEGSHIFT) + (extralight * LIGHTBRIGHT);
+  if (map_format.hexen)
+  {
+    int scrollOffset = leveltime >> 1 & 63;
+
+    switch (pl->special)
+    {                       // Handle scrolling flats
+      case 201:
+      case 202:
+      case 203:          // Scroll_North_xxx
+        dsvars->source = dsvars->source + ((scrollOffset
+                                   << (pl->special - 201) & 63) << 6);
+        break;
+      case 204:
+      case 205:
+      case 206:          // Scroll_East_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 204) & 63);
+        break;
+      case 207:
+      case 208:
+      case 209:          // Scroll_South_xxx
+        dsvars->source = dsvars->source + (((63 - scrollOffset)
+                                   << (pl->special - 207) & 63) << 6);
+        break;
+      case 210:
+      case 211:
+      case 212:          // Scroll_West_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 210) & 63);
+        break;
+      case 213:
+      case 214:
+      case 215:          // Scroll_NorthWest_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 213) & 63) +
+            ((scrollOffset << (pl->special - 213) & 63) << 6);
+        break;
+      case 216:
+      case 217:
+      case 218:          // Scroll_NorthEast_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 216) & 63) +
+            ((scrollOffset << (pl->special - 216) & 63) << 6);
+        break;
+      case 219:
+      case 220:
+      case 221:          // Scroll_SouthEast_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 219) & 63) +
+            (((63 - scrollOffset) << (pl->special - 219) & 63) << 6);
+        break;
+      case 222:
+      case 223:
+      case 224:          // Scroll_SouthWest_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 222) & 63) +
+            (((63 - scrollOffset) << (pl->special - 222) & 63) << 6);
+        break;
+      default:
+        break;
+    }
+  }
+  else if (heretic)
+  {
+    switch (pl->special)
+    {
+      case 20:
+      case 21:
+      case 22:
+      case 23:
+      case 24:           // Scroll_East
+        dsvars->source = dsvars->source +
+          ((63 - ((leveltime >> 1) & 63)) << (pl->special - 20) & 63);
+        break;
+      case 4:            // Scroll_EastLavaDamage
+        dsvars->source = dsvars->source +
+          (((63 - ((leveltime >> 1) & 63)) << 3) & 63);
+        break;
+    }
+  }
+
+  dsvars->planeheight = D_abs(pl->height-viewz);
+
+  // SoM 10/19/02: deep water colormap fix
+  if(fixedcolormap)
+    light = (255  >> LIGHTSEGSHIFT);
+  else
+    light = (pl->lightlevel >> LIGHTSEGSHIFT) + (extralight * LIGHTBRIGHT);
 
-      if(light >= LIGHTLEVELS)
-        light = LIGHTLEVELS-1;
+  if(light >= LIGHTLEVELS)
+    light = LIGHTLEVELS-1;
+
+  if(light < 0)
+    light = 0;
+
+  stop = pl->maxx + 1;
+  dsvars->planezlight = zlight[light];
+  pl->top[pl->minx-1] = pl->top[stop] = SHRT_MAX; // dropoff overflow
+}
+
+static void R_DrawFlatPlaneStrip(const flat_plane_t *flat, const plane_strip_t *strip)
+{
+  int x, stop;
+  const visplane_t *pl = flat->pl;
+  draw_span_vars_t dsvars = flat->dsvars;
 
-      if(light < 0)
-        light = 0;
+  if (pl->minx > strip->x2 || pl->maxx < strip->x1)
+    return;
+
+  stop = pl->maxx + 1;
+  if (stop > strip->x2 + 1)
+    stop = strip->x2 + 1;
+
+  x = pl->minx;
+
+  // Unscaled texture coordinates are linear in x, so the spans can start
+  //  at the strip edge. Scaled ones are rounded after the start is applied,
+  //  so those strips walk from the start of the plane.
+  if (x < strip->x1 && dsvars.xscale == FRACUNIT && dsvars.yscale == FRACUNIT)
+  {
+    x = strip->x1;
+    R_MakeSpans(x, SHRT_MAX, 0, pl->top[x], pl->bottom[x], &dsvars, strip);
+    x++;
+  }
+
+  for ( ; x < stop ; x++)
+     R_MakeSpans(x,pl->top[x-1],pl->bottom[x-1],
+                 pl->top[x],pl->bottom[x], &dsvars, strip);
+
+  // Close the spans still open at the end of the plane or the strip
+  R_MakeSpans(stop, pl->top[stop-1], pl->bottom[stop-1], SHRT_MAX, 0, &dsvars, strip);
+}
+
+static void R_DrawFlatPlanes(const plane_strip_t *strip)
+{
+  int i;
+
+  for (i = 0; i < flat_plane_count; i++)
+    R_DrawFlatPlaneStrip(&flat_planes[i], strip);
+}
+
+static int R_PlaneStripThread(void *data)
+{
+  plane_strip_t *strip = data;
+
+  while (1)
+  {
+    SDL_SemWait(strip->start);
+
+    if (plane_threads_quit)
+      break;
+
+    DSDA_TRACE_BEGIN("planes_strip");
+    R_DrawFlatPlanes(strip);
+    DSDA_TRACE_END("planes_strip");
+
+    SDL_SemPost(plane_strips_done);
+  }
+
+  return 0;
+}
+
+static void R_StopPlaneThreads(void)
+{
+  int i;
 
-      stop = pl->maxx + 1;
-      dsvars.planezlight = zlight[light];
-      pl->top[pl->minx-1] = pl->top[stop] = SHRT_MAX; // dropoff overflow
+  plane_threads_quit = true;
 
-      for (x = pl->minx ; x <= stop ; x++)
-         R_MakeSpans(x,pl->top[x-1],pl->bottom[x-1],
-                     pl->top[x],pl->bottom[x], &dsvars);
+  for (i = 1; i <= plane_thread_count; i++)
+  {
+    SDL_SemPost(plane_strips[i].start);
+    SDL_WaitThread(plane_strips[i].thread, NULL);
+  }
+
+  plane_thread_count = 0;
+}
+
+static void R_StartPlaneThreads(int count)
+{
+  if (!plane_strips_done)
+  {
+    plane_strips_done = SDL_CreateSemaphore(0);
+
+    if (!plane_strips_done)
+      I_Error("R_StartPlaneThreads: %s", SDL_GetError());
+
+    I_AtExit(R_StopPlaneThreads, true, "R_StopPlaneThreads", exit_priority_normal);
+  }
+
+  while (plane_thread_count < count)
+  {
+    plane_strip_t *strip = &plane_strips[plane_thread_count + 1];
+
+    if (!strip->spanstart)
+      strip->spanstart = Z_Calloc(1, SCREENHEIGHT * sizeof(*strip->spanstart));
+
+    strip->start = SDL_CreateSemaphore(0);
+    strip->thread = SDL_CreateThread(R_PlaneStripThread, "render_planes", strip);
+
+    if (!strip->start || !strip->thread)
+    {
+      lprintf(LO_WARN, "R_StartPlaneThreads: %s\n", SDL_GetError());
+      break;
     }
+
+    plane_thread_count++;
   }
 }
 
@@ -774,12 +949,53 @@ static void R_DoDrawPlane(visplane_t *pl)
 void R_DrawPlanes (void)
 {
   visplane_t *pl;
-  int i;
+  int i, strip_count;
+
+  flat_plane_count = 0;
+
   for (i=0;i<MAXVISPLANES;i++)
     for (pl=visplanes[i]; pl; pl=pl->next)
     {
       dsda_RecordVisPlane();
 
-      R_DoDrawPlane(pl);
+      if (pl->minx > pl->maxx || pl->picnum == skyflatnum || pl->picnum & PL_SKYFLAT)
+        continue;
+
+      if (flat_plane_count == flat_plane_capacity)
+      {
+        flat_plane_capacity = flat_plane_capacity ? flat_plane_capacity * 2 : 128;
+        flat_planes = Z_Realloc(flat_planes, flat_plane_capacity * sizeof(*flat_planes));
+      }
+
+      flat_planes[flat_plane_count].pl = pl;
+      R_SetupFlatPlane(pl, &flat_planes[flat_plane_count].dsvars);
+      flat_plane_count++;
     }
+
+  strip_count = V_IsSoftwareMode() ? dsda_IntConfig(dsda_config_render_threads) : 1;
+
+  if (strip_count > plane_thread_count + 1)
+    R_StartPlaneThreads(strip_count - 1);
+
+  if (strip_count > plane_thread_count + 1)
+    strip_count = plane_thread_count + 1;
+
+  for (i = 0; i < strip_count; i++)
+  {
+    plane_strips[i].x1 = viewwidth * i / strip_count;
+    plane_strips[i].x2 = viewwidth * (i + 1) / strip_count - 1;
+  }
+
+  for (i = 1; i < strip_count; i++)
+    SDL_SemPost(plane_strips[i].start);
+
+  for (i=0;i<MAXVISPLANES;i++)
+    for (pl=visplanes[i]; pl; pl=pl->next)
+      if (pl->minx <= pl->maxx && (pl->picnum == skyflatnum || pl->picnum & PL_SKYFLAT))
+        R_DrawSkyPlane(pl);
+
+  R_DrawFlatPlanes(&plane_strips[0]);
+
+  for (i = 1; i < strip_count; i++)
+    SDL_SemWait(plane_strips_done);
 }
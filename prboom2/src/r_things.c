@@ -79,19 +79,39 @@ typedef struct drawseg_xrange_item_s
   drawseg_t *user;
 } drawseg_xrange_item_t;
 
-typedef struct drawsegs_xrange_s
-{
-  drawseg_xrange_item_t *items;
-  int count;
-} drawsegs_xrange_t;
-
-#define DS_RANGES_COUNT 3
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
-
 static drawseg_xrange_item_t *drawsegs_xrange;
 static unsigned int drawsegs_xrange_size = 0;
 static int drawsegs_xrange_count = 0;
 
+// Each bin of screen columns has a bit set for every drawseg_xrange item
+//  that overlaps it. A sprite only visits the items set in its own bins,
+//  in the same order as a scan of the whole array.
+#define DS_BIN_SHIFT 5
+
+static uint64_t *drawseg_bins;
+static int *drawseg_bin_first;
+static int *drawseg_bin_last;
+static int drawseg_bins_size;
+static int drawseg_bin_alloc;
+static int drawseg_bin_words;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define R_LowestBit(x) __builtin_ctzll(x)
+#else
+static int R_LowestBit(uint64_t x)
+{
+  int i = 0;
+
+  while (!(x & 1))
+  {
+    x >>= 1;
+    ++i;
+  }
+
+  return i;
+}
+#endif
+
 // constant arrays
 //  used for psprite clipping and initializing clipping
 
@@ -1300,80 +1320,108 @@ void R_DrawPlayerSprites(void)
 // linked lists, and to use faster sorting algorithm.
 //
 
-#ifdef DJGPP
+// Sprites are sorted by scale with a stable radix sort. Its input is laid
+//  out in the order killough's merge sort left equal scales in, so the
+//  result is the same. The sort buffers only ever grow.
 
-// killough 9/22/98: inlined memcpy of pointer arrays
-// CPhipps - added memory as modified
-#define bcopyp(d, s, n) asm(" cld; rep; movsl;" :: "D"(d), "S"(s), "c"(n) : "%cc", "%esi", "%edi", "%ecx", "memory")
-
-#else
-
-#define bcopyp(d, s, n) memcpy(d, s, (n) * sizeof(void *))
-
-#endif
+typedef struct
+{
+  unsigned int key;
+  vissprite_t *spr;
+} vissprite_sort_t;
 
-// killough 9/2/98: merge sort
+static vissprite_sort_t *vissprite_sort[2];
 
-static void msort(vissprite_t **s, vissprite_t **t, int n)
+// The merge sort put the later half first on equal scales,
+//  except in runs of fewer than 16, which kept their order.
+static vissprite_sort_t *R_OrderVisSprites(vissprite_sort_t *dest, int start, int n)
 {
   if (n >= 16)
-    {
-      int n1 = n/2, n2 = n - n1;
-      vissprite_t **s1 = s, **s2 = s + n1, **d = t;
+  {
+    int n1 = n / 2;
 
-      msort(s1, t, n1);
-      msort(s2, t, n2);
+    dest = R_OrderVisSprites(dest, start + n1, n - n1);
+    return R_OrderVisSprites(dest, start, n1);
+  }
 
-      while ((*s1)->scale > (*s2)->scale ?
-             (*d++ = *s1++, --n1) : (*d++ = *s2++, --n2));
+  while (n--)
+  {
+    // The merge sort input held the vissprites in reverse
+    vissprite_t *spr = vissprites + num_vissprite - 1 - start++;
 
-      if (n2)
-        bcopyp(d, s2, n2);
-      else
-        bcopyp(d, s1, n1);
+    // Larger scales sort first
+    dest->key = (unsigned int) spr->scale ^ 0x7fffffff;
+    dest->spr = spr;
+    dest++;
+  }
 
-      bcopyp(s, t, n);
-    }
-  else
-    {
-      int i;
-      for (i = 1; i < n; i++)
-        {
-          vissprite_t *temp = s[i];
-          if (s[i-1]->scale < temp->scale)
-            {
-              int j = i;
-              while ((s[j] = s[j-1])->scale < temp->scale && --j);
-              s[j] = temp;
-            }
-        }
-    }
+  return dest;
 }
 
 void R_SortVisSprites (void)
 {
   if (num_vissprite)
     {
-      int i = num_vissprite;
-
-      // If we need to allocate more pointers for the vissprites,
-      // allocate as many as were allocated for sprites -- killough
-      // killough 9/22/98: allocate twice as many
+      int counts[4][256];
+      vissprite_sort_t *src, *dst;
+      int i, j, pass;
 
-      if (num_vissprite_ptrs < num_vissprite*2)
+      if (num_vissprite_ptrs < num_vissprite)
         {
+          num_vissprite_ptrs = num_vissprite_alloc;
+
           Z_Free(vissprite_ptrs);  // better than realloc -- no preserving needed
-          vissprite_ptrs = Z_Malloc((num_vissprite_ptrs = num_vissprite_alloc*2)
-                                  * sizeof *vissprite_ptrs);
+          vissprite_ptrs = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_ptrs);
+
+          for (i = 0; i < 2; i++)
+            {
+              Z_Free(vissprite_sort[i]);
+              vissprite_sort[i] = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_sort[i]);
+            }
         }
 
-      while (--i>=0)
-        vissprite_ptrs[num_vissprite-i-1] = vissprites+i;
+      src = vissprite_sort[0];
+      dst = vissprite_sort[1];
+
+      R_OrderVisSprites(src, 0, num_vissprite);
+
+      memset(counts, 0, sizeof(counts));
+
+      for (i = 0; i < num_vissprite; i++)
+        for (pass = 0; pass < 4; pass++)
+          counts[pass][(src[i].key >> (pass * 8)) & 0xff]++;
+
+      for (pass = 0; pass < 4; pass++)
+        {
+          const int shift = pass * 8;
+          int *count = counts[pass];
+          int offset = 0;
+
+          // Nothing to do when every key has the same digit
+          if (count[(src[0].key >> shift) & 0xff] == num_vissprite)
+            continue;
+
+          for (j = 0; j < 256; j++)
+            {
+              int n = count[j];
+
+              count[j] = offset;
+              offset += n;
+            }
+
+          for (i = 0; i < num_vissprite; i++)
+            dst[count[(src[i].key >> shift) & 0xff]++] = src[i];
 
-      // killough 9/22/98: replace qsort with merge sort, since the keys
-      // are roughly in order to begin with, due to BSP rendering.
+          {
+            vissprite_sort_t *temp = src;
+
+            src = dst;
+            dst = temp;
+          }
+        }
 
-      msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
+      for (i = 0; i < num_vissprite; i++)
+        vissprite_ptrs[i] = src[i].spr;
     }
 }
 
@@ -1403,56 +1451,80 @@ static void R_DrawSprite (vissprite_t* spr)
   // and buggy, by going past LEFT end of array):
 
   // e6y: optimization
-  if (drawsegs_xrange_size)
+  if (drawsegs_xrange_count)
   {
-    const drawseg_xrange_item_t *last = &drawsegs_xrange[drawsegs_xrange_count - 1];
-    drawseg_xrange_item_t *curr = &drawsegs_xrange[-1];
-    while (++curr <= last)
+    const int bin1 = spr->x1 >> DS_BIN_SHIFT;
+    const int bin2 = spr->x2 >> DS_BIN_SHIFT;
+    int first = drawseg_bin_words;
+    int last = 0;
+    int bin, word;
+
+    for (bin = bin1; bin <= bin2; bin++)
     {
-      // determine if the drawseg obscures the sprite
-      if (curr->x1 > spr->x2 || curr->x2 < spr->x1)
-        continue;      // does not cover sprite
+      if (drawseg_bin_first[bin] < first)
+        first = drawseg_bin_first[bin];
+      if (drawseg_bin_last[bin] > last)
+        last = drawseg_bin_last[bin];
+    }
 
-      ds = curr->user;
+    for (word = first; word < last; word++)
+    {
+      uint64_t bits = 0;
 
-      if (ds->scale1 > ds->scale2)
-      {
-        lowscale = ds->scale2;
-        scale = ds->scale1;
-      }
-      else
-      {
-        lowscale = ds->scale1;
-        scale = ds->scale2;
-      }
+      for (bin = bin1; bin <= bin2; bin++)
+        bits |= drawseg_bins[bin * drawseg_bin_words + word];
 
-      if (scale < spr->scale || (lowscale < spr->scale &&
-        !R_PointOnSegSide (spr->gx, spr->gy, ds->curline)))
+      while (bits)
       {
-        if (ds->maskedtexturecol)       // masked mid texture?
+        const drawseg_xrange_item_t *curr = &drawsegs_xrange[(word << 6) + R_LowestBit(bits)];
+
+        bits &= bits - 1;
+
+        // determine if the drawseg obscures the sprite
+        if (curr->x1 > spr->x2 || curr->x2 < spr->x1)
+          continue;      // does not cover sprite
+
+        ds = curr->user;
+
+        if (ds->scale1 > ds->scale2)
         {
-          r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
-          r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
-          R_RenderMaskedSegRange(ds, r1, r2);
+          lowscale = ds->scale2;
+          scale = ds->scale1;
+        }
+        else
+        {
+          lowscale = ds->scale1;
+          scale = ds->scale2;
         }
-        continue;               // seg is behind sprite
-      }
 
-      r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
-      r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
+        if (scale < spr->scale || (lowscale < spr->scale &&
+          !R_PointOnSegSide (spr->gx, spr->gy, ds->curline)))
+        {
+          if (ds->maskedtexturecol)       // masked mid texture?
+          {
+            r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
+            r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
+            R_RenderMaskedSegRange(ds, r1, r2);
+          }
+          continue;               // seg is behind sprite
+        }
 
-      // clip this piece of the sprite
-      // killough 3/27/98: optimized and made much shorter
+        r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
+        r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
 
-      if (ds->silhouette&SIL_BOTTOM && spr->gz < ds->bsilheight) //bottom sil
-        for (x=r1 ; x<=r2 ; x++)
-          if (clipbot[x] == -2)
-            clipbot[x] = ds->sprbottomclip[x];
+        // clip this piece of the sprite
+        // killough 3/27/98: optimized and made much shorter
 
-      if (ds->silhouette&SIL_TOP && spr->gzt > ds->tsilheight)   // top sil
-        for (x=r1 ; x<=r2 ; x++)
-          if (cliptop[x] == -2)
-            cliptop[x] = ds->sprtopclip[x];
+        if (ds->silhouette&SIL_BOTTOM && spr->gz < ds->bsilheight) //bottom sil
+          for (x=r1 ; x<=r2 ; x++)
+            if (clipbot[x] == -2)
+              clipbot[x] = ds->sprbottomclip[x];
+
+        if (ds->silhouette&SIL_TOP && spr->gzt > ds->tsilheight)   // top sil
+          for (x=r1 ; x<=r2 ; x++)
+            if (cliptop[x] == -2)
+              cliptop[x] = ds->sprtopclip[x];
+      }
     }
   }
 
@@ -1515,6 +1587,59 @@ static void R_DrawSprite (vissprite_t* spr)
   R_DrawVisSprite (spr);
 }
 
+//
+// R_BinDrawSegs
+//
+
+static void R_BinDrawSegs(void)
+{
+  int i, bin, bin_count, size;
+
+  if (!drawsegs_xrange_count)
+    return;
+
+  bin_count = ((viewwidth - 1) >> DS_BIN_SHIFT) + 1;
+  drawseg_bin_words = (drawsegs_xrange_count + 63) >> 6;
+  size = bin_count * drawseg_bin_words;
+
+  if (drawseg_bins_size < size)
+  {
+    drawseg_bins_size = 2 * size;
+    drawseg_bins = Z_Realloc(drawseg_bins, drawseg_bins_size * sizeof(*drawseg_bins));
+  }
+
+  if (drawseg_bin_alloc < bin_count)
+  {
+    drawseg_bin_alloc = bin_count;
+    drawseg_bin_first = Z_Realloc(drawseg_bin_first, drawseg_bin_alloc * sizeof(*drawseg_bin_first));
+    drawseg_bin_last = Z_Realloc(drawseg_bin_last, drawseg_bin_alloc * sizeof(*drawseg_bin_last));
+  }
+
+  memset(drawseg_bins, 0, size * sizeof(*drawseg_bins));
+
+  for (bin = 0; bin < bin_count; bin++)
+  {
+    drawseg_bin_first[bin] = drawseg_bin_words;
+    drawseg_bin_last[bin] = 0;
+  }
+
+  for (i = 0; i < drawsegs_xrange_count; i++)
+  {
+    const int word = i >> 6;
+    const uint64_t bit = (uint64_t) 1 << (i & 63);
+    const int last = drawsegs_xrange[i].x2 >> DS_BIN_SHIFT;
+
+    for (bin = drawsegs_xrange[i].x1 >> DS_BIN_SHIFT; bin <= last; bin++)
+    {
+      drawseg_bins[bin * drawseg_bin_words + word] |= bit;
+
+      if (drawseg_bin_first[bin] > word)
+        drawseg_bin_first[bin] = word;
+      drawseg_bin_last[bin] = word + 1;
+    }
+  }
+}
+
 //
 // R_DrawMasked
 //
@@ -1523,7 +1648,6 @@ void R_DrawMasked(void)
 {
   int i;
   drawseg_t *ds;
-  int cx = SCREENWIDTH / 2;
 
   R_SortVisSprites();
 
@@ -1531,46 +1655,28 @@ void R_DrawMasked(void)
   // Reducing of cache misses in the following R_DrawSprite()
   // Makes sense for scenes with huge amount of drawsegs.
   // ~12% of speed improvement on epic.wad map05
-  for(i = 0; i < DS_RANGES_COUNT; i++)
-    drawsegs_xranges[i].count = 0;
+  drawsegs_xrange_count = 0;
 
   if (num_vissprite > 0)
   {
     if (drawsegs_xrange_size < maxdrawsegs)
     {
       drawsegs_xrange_size = 2 * maxdrawsegs;
-      for(i = 0; i < DS_RANGES_COUNT; i++)
-      {
-        drawsegs_xranges[i].items = Z_Realloc(
-          drawsegs_xranges[i].items,
-          drawsegs_xrange_size * sizeof(drawsegs_xranges[i].items[0]));
-      }
+      drawsegs_xrange = Z_Realloc(drawsegs_xrange,
+                                  drawsegs_xrange_size * sizeof(drawsegs_xrange[0]));
     }
     for (ds = ds_p; ds-- > drawsegs;)
     {
       if (ds->silhouette || ds->maskedtexturecol)
       {
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].x1 = ds->x1;
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].x2 = ds->x2;
-        drawsegs_xranges[0].items[drawsegs_xranges[0].count].user = ds;
-
-        // e6y: ~13% of speed improvement on sunder.wad map10
-        if (ds->x1 < cx)
-        {
-          drawsegs_xranges[1].items[drawsegs_xranges[1].count] =
-            drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-          drawsegs_xranges[1].count++;
-        }
-        if (ds->x2 >= cx)
-        {
-          drawsegs_xranges[2].items[drawsegs_xranges[2].count] =
-            drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-          drawsegs_xranges[2].count++;
-        }
-
-        drawsegs_xranges[0].count++;
+        drawsegs_xrange[drawsegs_xrange_count].x1 = ds->x1;
+        drawsegs_xrange[drawsegs_xrange_count].x2 = ds->x2;
+        drawsegs_xrange[drawsegs_xrange_count].user = ds;
+        drawsegs_xrange_count++;
       }
     }
+
+    R_BinDrawSegs();
   }
 
   // draw all vissprites back to front
@@ -1578,27 +1684,7 @@ void R_DrawMasked(void)
   dsda_RecordVisSprites(num_vissprite);
 
   for (i = num_vissprite ;--i>=0; )
-  {
-    vissprite_t* spr = vissprite_ptrs[i];
-
-    if (spr->x2 < cx)
-    {
-      drawsegs_xrange = drawsegs_xranges[1].items;
-      drawsegs_xrange_count = drawsegs_xranges[1].count;
-    }
-    else if (spr->x1 >= cx)
-    {
-      drawsegs_xrange = drawsegs_xranges[2].items;
-      drawsegs_xrange_count = drawsegs_xranges[2].count;
-    }
-    else
-    {
-      drawsegs_xrange = drawsegs_xranges[0].items;
-      drawsegs_xrange_count = drawsegs_xranges[0].count;
-    }
-
     R_DrawSprite(vissprite_ptrs[i]);
-  }
 
   // render any remaining masked mid textures
 
@@ -484,6 +484,7 @@ static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
 
     drawvars.topleft = screens[scrn].data;
     drawvars.pitch = screens[scrn].pitch;
+    drawvars.xpitch = 1;
 
     if (flags & VPT_TRANS) {
       colfunc = R_GetDrawColumnFunc(RDC_PIPELINE_TRANSLATED, RDRAW_FILTER_NONE);
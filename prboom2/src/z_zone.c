@@ -48,12 +48,15 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "z_zone.h"
 #include "doomstat.h"
 #include "v_video.h"
 #include "g_game.h"
+#include "i_system.h"
 #include "lprintf.h"
+#include "m_file.h"
 
 #ifdef DJGPP
 #include <dpmi.h>
@@ -67,8 +70,12 @@ enum {
   ZONE_MAX
 };
 
+// Sites that allocate from the level arena have no block tag
+#define ZONE_SITE_ARENA ZONE_MAX
+
 typedef struct memblock {
   unsigned signature;
+  int site;                   // 1-based index into zone_sites, 0 if untracked
   struct memblock *next,*prev;
   size_t size;
   unsigned char tag;
@@ -78,6 +85,167 @@ static const size_t HEADER_SIZE = sizeof(memblock_t);
 
 static memblock_t *blockbytag[ZONE_MAX];
 
+// Call site statistics
+// Only blocks allocated while the statistics are enabled carry a site,
+//  so freeing older blocks does not disturb the counts.
+// The tables use malloc directly - they must not allocate through the zone.
+
+typedef struct {
+  const char *file;
+  int line;
+  int tag;
+  size_t live_bytes;
+  size_t peak_bytes;
+  size_t total_bytes;
+  unsigned int live_count;
+  unsigned int allocations;
+} zone_site_t;
+
+static dboolean zone_site_stats;
+static const char *zone_site_stats_filename;
+static zone_site_t *zone_sites;
+static int zone_site_count;
+static int zone_site_capacity;
+static int *zone_site_hash;
+static int zone_site_hash_size;
+static size_t zone_live_bytes;
+static size_t zone_peak_bytes;
+
+static const char *zone_tag_names[ZONE_MAX + 1] = { "static", "level", "arena" };
+
+static unsigned int Z_SiteHash(const char *file, int line)
+{
+  return (unsigned int) (((size_t) file >> 3) ^ ((unsigned int) line * 2654435761u));
+}
+
+static void Z_RehashSites(void)
+{
+  int i;
+
+  free(zone_site_hash);
+
+  zone_site_hash_size = zone_site_hash_size ? zone_site_hash_size * 2 : 1024;
+  zone_site_hash = calloc(zone_site_hash_size, sizeof(*zone_site_hash));
+
+  if (!zone_site_hash)
+    I_Error("Z_RehashSites: Failure trying to allocate the site table");
+
+  for (i = 0; i < zone_site_count; ++i)
+  {
+    unsigned int h = Z_SiteHash(zone_sites[i].file, zone_sites[i].line);
+
+    while (zone_site_hash[h & (zone_site_hash_size - 1)])
+      ++h;
+
+    zone_site_hash[h & (zone_site_hash_size - 1)] = i + 1;
+  }
+}
+
+static int Z_FindSite(const char *file, int line, int tag)
+{
+  unsigned int h;
+  zone_site_t *site;
+
+  if (zone_site_count * 2 >= zone_site_hash_size)
+    Z_RehashSites();
+
+  // __FILE__ is the same pointer within a translation unit
+  for (h = Z_SiteHash(file, line); zone_site_hash[h & (zone_site_hash_size - 1)]; ++h)
+  {
+    int index = zone_site_hash[h & (zone_site_hash_size - 1)];
+
+    if (zone_sites[index - 1].file == file && zone_sites[index - 1].line == line)
+      return index;
+  }
+
+  if (zone_site_count == zone_site_capacity)
+  {
+    zone_site_capacity = zone_site_capacity ? zone_site_capacity * 2 : 512;
+    zone_sites = realloc(zone_sites, zone_site_capacity * sizeof(*zone_sites));
+
+    if (!zone_sites)
+      I_Error("Z_FindSite: Failure trying to allocate the site table");
+  }
+
+  site = &zone_sites[zone_site_count++];
+  memset(site, 0, sizeof(*site));
+  site->file = file;
+  site->line = line;
+  site->tag = tag;
+
+  zone_site_hash[h & (zone_site_hash_size - 1)] = zone_site_count;
+
+  return zone_site_count;
+}
+
+static void Z_AddSite(memblock_t *block, const char *file, int line)
+{
+  zone_site_t *site;
+
+  block->site = Z_FindSite(file, line, block->tag);
+
+  site = &zone_sites[block->site - 1];
+  site->live_bytes += block->size;
+  site->total_bytes += block->size;
+  ++site->live_count;
+  ++site->allocations;
+
+  if (site->live_bytes > site->peak_bytes)
+    site->peak_bytes = site->live_bytes;
+
+  zone_live_bytes += block->size;
+
+  if (zone_live_bytes > zone_peak_bytes)
+    zone_peak_bytes = zone_live_bytes;
+}
+
+static void Z_RemoveSite(memblock_t *block)
+{
+  zone_site_t *site = &zone_sites[block->site - 1];
+
+  site->live_bytes -= block->size;
+  --site->live_count;
+
+  zone_live_bytes -= block->size;
+}
+
+// Arena memory has no header, so growth in place adds bytes without a block
+static void Z_AddArenaSite(size_t size, dboolean new_block, const char *file, int line)
+{
+  int index = Z_FindSite(file, line, ZONE_SITE_ARENA);
+  zone_site_t *site = &zone_sites[index - 1];
+
+  site->live_bytes += size;
+  site->total_bytes += size;
+
+  if (new_block)
+  {
+    ++site->live_count;
+    ++site->allocations;
+  }
+
+  if (site->live_bytes > site->peak_bytes)
+    site->peak_bytes = site->live_bytes;
+
+  zone_live_bytes += size;
+
+  if (zone_live_bytes > zone_peak_bytes)
+    zone_peak_bytes = zone_live_bytes;
+}
+
+static void Z_ClearArenaSites(void)
+{
+  int i;
+
+  for (i = 0; i < zone_site_count; ++i)
+    if (zone_sites[i].tag == ZONE_SITE_ARENA)
+    {
+      zone_live_bytes -= zone_sites[i].live_bytes;
+      zone_sites[i].live_bytes = 0;
+      zone_sites[i].live_count = 0;
+    }
+}
+
 /* Z_Malloc
  * cph - the algorithm here was a very simple first-fit round-robin
  *  one - just keep looping around, freeing everything we can until
@@ -88,7 +256,7 @@ static memblock_t *blockbytag[ZONE_MAX];
  * free all the stuff we just pass on the way.
  */
 
-static void *Z_MallocTag(size_t size, int tag)
+static void *Z_MallocTag(size_t size, int tag, const char *file, int line)
 {
   memblock_t *block = NULL;
 
@@ -97,7 +265,8 @@ static void *Z_MallocTag(size_t size, int tag)
 
   if (!(block = malloc(size + HEADER_SIZE)))
   {
-    I_Error ("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long) size);
+    I_Error ("Z_Malloc: Failure trying to allocate %lu bytes (%s:%d)",
+             (unsigned long) size, file, line);
   }
 
   if (!blockbytag[tag])
@@ -116,6 +285,11 @@ static void *Z_MallocTag(size_t size, int tag)
   block->size = size;
   block->signature = ZONE_SIGNATURE;
   block->tag = tag;           // tag
+  block->site = 0;
+
+  if (zone_site_stats)
+    Z_AddSite(block, file, line);
+
   block = (memblock_t *)((char *) block + HEADER_SIZE);
 
   return block;
@@ -132,6 +306,9 @@ void Z_Free(void *p)
     I_Error("Z_Free: freed a non-zone pointer");
   block->signature = 0;       // Nullify signature so another free fails
 
+  if (block->site)
+    Z_RemoveSite(block);
+
   if (block == block->next)
     blockbytag[block->tag] = NULL;
   else
@@ -164,9 +341,9 @@ static void Z_FreeTag(int tag)
   }
 }
 
-static void *Z_ReallocTag(void *ptr, size_t n, int tag)
+static void *Z_ReallocTag(void *ptr, size_t n, int tag, const char *file, int line)
 {
-  void *p = Z_MallocTag(n, tag);
+  void *p = Z_MallocTag(n, tag, file, line);
   if (ptr)
     {
       memblock_t *block = (memblock_t *)((char *) ptr - HEADER_SIZE);
@@ -176,58 +353,494 @@ static void *Z_ReallocTag(void *ptr, size_t n, int tag)
   return p;
 }
 
-static void *Z_CallocTag(size_t n1, size_t n2, int tag)
+static void *Z_CallocTag(size_t n1, size_t n2, int tag, const char *file, int line)
 {
   return
-    (n1*=n2) ? memset(Z_MallocTag(n1, tag), 0, n1) : NULL;
+    (n1*=n2) ? memset(Z_MallocTag(n1, tag, file, line), 0, n1) : NULL;
+}
+
+static char *Z_StrdupTag(const char *s, int tag, const char *file, int line)
+{
+  return strcpy(Z_MallocTag(strlen(s)+1, tag, file, line), s);
+}
+
+void *(Z_Malloc)(size_t size, const char *file, int line)
+{
+  return Z_MallocTag(size, ZONE_STATIC, file, line);
+}
+
+void *(Z_Calloc)(size_t n, size_t n2, const char *file, int line)
+{
+  return Z_CallocTag(n, n2, ZONE_STATIC, file, line);
+}
+
+void *(Z_Realloc)(void *p, size_t n, const char *file, int line)
+{
+  return Z_ReallocTag(p, n, ZONE_STATIC, file, line);
+}
+
+char *(Z_Strdup)(const char *s, const char *file, int line)
+{
+  return Z_StrdupTag(s, ZONE_STATIC, file, line);
+}
+
+// Level arena
+// Level data that is never freed on its own is bump allocated from chunks,
+//  so allocation is a pointer increment and Z_FreeLevel drops whole chunks.
+// Large requests get a chunk of their own and leave the current one open.
+// A few standard chunks are kept for the next level.
+
+#define ARENA_CHUNK_SIZE (256 * 1024)
+#define ARENA_ALIGN 16
+#define ARENA_SPARE_MAX 8
+
+#define ARENA_ROUND(x) (((x) + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1))
+
+typedef struct arena_chunk_s {
+  struct arena_chunk_s *next;
+  size_t size;
+} arena_chunk_t;
+
+#define ARENA_HEADER_SIZE ARENA_ROUND(sizeof(arena_chunk_t))
+
+static arena_chunk_t *arena_chunks;
+static arena_chunk_t *arena_spare;
+static int arena_spare_count;
+static char *arena_top;
+static char *arena_end;
+static char *arena_last;
+static int arena_chunk_count;
+static size_t arena_used_bytes;
+
+static arena_chunk_t *Z_NewArenaChunk(size_t size)
+{
+  arena_chunk_t *chunk;
+
+  if (size == ARENA_CHUNK_SIZE && arena_spare)
+  {
+    chunk = arena_spare;
+    arena_spare = chunk->next;
+    --arena_spare_count;
+  }
+  else if (!(chunk = malloc(ARENA_HEADER_SIZE + size)))
+  {
+    I_Error("Z_ArenaMalloc: Failure trying to allocate %lu bytes", (unsigned long) size);
+  }
+
+  chunk->size = size;
+  ++arena_chunk_count;
+
+  return chunk;
 }
 
-static char *Z_StrdupTag(const char *s, int tag)
+static void *Z_ArenaAlloc(size_t size)
 {
-  return strcpy(Z_MallocTag(strlen(s)+1, tag), s);
+  char *p;
+
+  size = ARENA_ROUND(size);
+
+  if (size > (size_t) (arena_end - arena_top))
+  {
+    arena_chunk_t *chunk;
+
+    if (size > ARENA_CHUNK_SIZE / 4)
+    {
+      chunk = Z_NewArenaChunk(size);
+
+      if (arena_chunks)
+      {
+        chunk->next = arena_chunks->next;
+        arena_chunks->next = chunk;
+      }
+      else
+      {
+        chunk->next = NULL;
+        arena_chunks = chunk;
+      }
+
+      arena_used_bytes += size;
+      arena_last = NULL;
+
+      return (char *) chunk + ARENA_HEADER_SIZE;
+    }
+
+    chunk = Z_NewArenaChunk(ARENA_CHUNK_SIZE);
+    chunk->next = arena_chunks;
+    arena_chunks = chunk;
+
+    arena_top = (char *) chunk + ARENA_HEADER_SIZE;
+    arena_end = arena_top + ARENA_CHUNK_SIZE;
+  }
+
+  p = arena_top;
+  arena_top += size;
+  arena_last = p;
+  arena_used_bytes += size;
+
+  return p;
+}
+
+static void Z_FreeArena(void)
+{
+  while (arena_chunks)
+  {
+    arena_chunk_t *next = arena_chunks->next;
+
+    if (arena_chunks->size == ARENA_CHUNK_SIZE && arena_spare_count < ARENA_SPARE_MAX)
+    {
+      arena_chunks->next = arena_spare;
+      arena_spare = arena_chunks;
+      ++arena_spare_count;
+    }
+    else
+      free(arena_chunks);
+
+    arena_chunks = next;
+  }
+
+  arena_top = arena_end = arena_last = NULL;
+  arena_chunk_count = 0;
+  arena_used_bytes = 0;
+
+  if (zone_site_stats)
+    Z_ClearArenaSites();
 }
 
-void *Z_Malloc(size_t size)
+void *(Z_ArenaMalloc)(size_t size, const char *file, int line)
 {
-  return Z_MallocTag(size, ZONE_STATIC);
+  if (!size)
+    return NULL;
+
+  if (zone_site_stats)
+    Z_AddArenaSite(size, true, file, line);
+
+  return Z_ArenaAlloc(size);
 }
 
-void *Z_Calloc(size_t n, size_t n2)
+void *(Z_ArenaCalloc)(size_t n, size_t n2, const char *file, int line)
 {
-  return Z_CallocTag(n, n2, ZONE_STATIC);
+  return
+    (n*=n2) ? memset((Z_ArenaMalloc)(n, file, line), 0, n) : NULL;
 }
 
-void *Z_Realloc(void *p, size_t n)
+// The most recent allocation grows in place, anything else is copied
+void *(Z_ArenaRealloc)(void *p, size_t old_size, size_t n, const char *file, int line)
 {
-  return Z_ReallocTag(p, n, ZONE_STATIC);
+  void *result;
+
+  if (p && p == arena_last && ARENA_ROUND(n) <= (size_t) (arena_end - arena_last))
+  {
+    arena_used_bytes += ARENA_ROUND(n) - (arena_top - arena_last);
+    arena_top = arena_last + ARENA_ROUND(n);
+
+    if (zone_site_stats && n > old_size)
+      Z_AddArenaSite(n - old_size, false, file, line);
+
+    return p;
+  }
+
+  result = (Z_ArenaMalloc)(n, file, line);
+
+  if (p && result)
+    memcpy(result, p, n <= old_size ? n : old_size);
+
+  return result;
 }
 
-char *Z_Strdup(const char *s)
+char *(Z_ArenaStrdup)(const char *s, const char *file, int line)
 {
-  return Z_StrdupTag(s, ZONE_STATIC);
+  return strcpy((Z_ArenaMalloc)(strlen(s) + 1, file, line), s);
 }
 
 void Z_FreeLevel(void)
 {
+  Z_FreeArena();
+
   return Z_FreeTag(ZONE_LEVEL);
 }
 
-void *Z_MallocLevel(size_t size)
+void *(Z_MallocLevel)(size_t size, const char *file, int line)
+{
+  return Z_MallocTag(size, ZONE_LEVEL, file, line);
+}
+
+void *(Z_CallocLevel)(size_t n, size_t n2, const char *file, int line)
+{
+  return Z_CallocTag(n, n2, ZONE_LEVEL, file, line);
+}
+
+void *(Z_ReallocLevel)(void *p, size_t n, const char *file, int line)
+{
+  return Z_ReallocTag(p, n, ZONE_LEVEL, file, line);
+}
+
+char *(Z_StrdupLevel)(const char *s, const char *file, int line)
+{
+  return Z_StrdupTag(s, ZONE_LEVEL, file, line);
+}
+
+// Call site reports
+
+typedef struct {
+  const char *file;
+  size_t live_bytes;
+  size_t peak_bytes;
+  unsigned int live_count;
+  unsigned int allocations;
+} zone_file_t;
+
+// Trim the build path so sites read as e.g. "dsda/demo.c"
+static const char *Z_SiteFileName(const char *file)
+{
+  const char *p;
+  const char *result = file;
+
+  for (p = file; *p; ++p)
+    if (!strncmp(p, "src/", 4) || !strncmp(p, "src\\", 4))
+      result = p + 4;
+
+  return result;
+}
+
+static int Z_CompareSitesByLive(const void *a, const void *b)
+{
+  const zone_site_t *site_a = *(const zone_site_t * const *) a;
+  const zone_site_t *site_b = *(const zone_site_t * const *) b;
+
+  if (site_a->live_bytes != site_b->live_bytes)
+    return site_a->live_bytes < site_b->live_bytes ? 1 : -1;
+
+  return site_a->peak_bytes < site_b->peak_bytes ? 1 :
+         site_a->peak_bytes > site_b->peak_bytes ? -1 : 0;
+}
+
+static int Z_CompareSitesByPeak(const void *a, const void *b)
+{
+  const zone_site_t *site_a = *(const zone_site_t * const *) a;
+  const zone_site_t *site_b = *(const zone_site_t * const *) b;
+
+  if (site_a->peak_bytes != site_b->peak_bytes)
+    return site_a->peak_bytes < site_b->peak_bytes ? 1 : -1;
+
+  return site_a->live_bytes < site_b->live_bytes ? 1 :
+         site_a->live_bytes > site_b->live_bytes ? -1 : 0;
+}
+
+static int Z_CompareFiles(const void *a, const void *b)
+{
+  const zone_file_t *file_a = a;
+  const zone_file_t *file_b = b;
+
+  if (file_a->live_bytes != file_b->live_bytes)
+    return file_a->live_bytes < file_b->live_bytes ? 1 : -1;
+
+  return file_a->peak_bytes < file_b->peak_bytes ? 1 :
+         file_a->peak_bytes > file_b->peak_bytes ? -1 : 0;
+}
+
+static zone_site_t **Z_SortedSites(int (*compare)(const void *, const void *))
+{
+  int i;
+  zone_site_t **sorted;
+
+  sorted = malloc((zone_site_count + 1) * sizeof(*sorted));
+
+  if (!sorted)
+    return NULL;
+
+  for (i = 0; i < zone_site_count; ++i)
+    sorted[i] = &zone_sites[i];
+
+  qsort(sorted, zone_site_count, sizeof(*sorted), compare);
+
+  return sorted;
+}
+
+// A file's peak is the sum of its site peaks - an upper bound,
+//  since the sites need not peak at the same time.
+static zone_file_t *Z_SortedFiles(int *count)
+{
+  int i, j;
+  zone_file_t *files;
+
+  *count = 0;
+  files = malloc((zone_site_count + 1) * sizeof(*files));
+
+  if (!files)
+    return NULL;
+
+  for (i = 0; i < zone_site_count; ++i)
+  {
+    const char *name = Z_SiteFileName(zone_sites[i].file);
+
+    for (j = 0; j < *count; ++j)
+      if (!strcmp(files[j].file, name))
+        break;
+
+    if (j == *count)
+    {
+      memset(&files[j], 0, sizeof(files[j]));
+      files[j].file = name;
+      ++*count;
+    }
+
+    files[j].live_bytes += zone_sites[i].live_bytes;
+    files[j].peak_bytes += zone_sites[i].peak_bytes;
+    files[j].live_count += zone_sites[i].live_count;
+    files[j].allocations += zone_sites[i].allocations;
+  }
+
+  qsort(files, *count, sizeof(*files), Z_CompareFiles);
+
+  return files;
+}
+
+void Z_PrintSiteStats(int limit)
 {
-  return Z_MallocTag(size, ZONE_LEVEL);
+  int i, file_count;
+  zone_site_t **sorted;
+  zone_file_t *files;
+
+  if (!zone_site_stats)
+  {
+    lprintf(LO_INFO, "Zone statistics are disabled (use -zone_stats)\n");
+    return;
+  }
+
+  lprintf(LO_INFO, "Zone: %lu KiB live, %lu KiB peak, %d sites\n",
+          (unsigned long) (zone_live_bytes >> 10),
+          (unsigned long) (zone_peak_bytes >> 10),
+          zone_site_count);
+  lprintf(LO_INFO, "Level arena: %lu KiB in %d chunks\n",
+          (unsigned long) (arena_used_bytes >> 10), arena_chunk_count);
+
+  sorted = Z_SortedSites(Z_CompareSitesByLive);
+  files = Z_SortedFiles(&file_count);
+
+  if (!sorted || !files)
+  {
+    free(sorted);
+    free(files);
+    return;
+  }
+
+  lprintf(LO_INFO, "Files:\n");
+
+  for (i = 0; i < file_count && i < limit; ++i)
+    lprintf(LO_INFO, "  %-32s %10lu KiB live %10lu KiB peak %8u blocks\n",
+            files[i].file,
+            (unsigned long) (files[i].live_bytes >> 10),
+            (unsigned long) (files[i].peak_bytes >> 10),
+            files[i].live_count);
+
+  lprintf(LO_INFO, "Sites:\n");
+
+  for (i = 0; i < zone_site_count && i < limit; ++i)
+  {
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s:%d", Z_SiteFileName(sorted[i]->file), sorted[i]->line);
+
+    lprintf(LO_INFO, "  %-32s %10lu KiB live %10lu KiB peak %8u blocks %10u allocs\n",
+            name,
+            (unsigned long) (sorted[i]->live_bytes >> 10),
+            (unsigned long) (sorted[i]->peak_bytes >> 10),
+            sorted[i]->live_count,
+            sorted[i]->allocations);
+  }
+
+  free(sorted);
+  free(files);
 }
 
-void *Z_CallocLevel(size_t n, size_t n2)
+static void Z_WriteSiteStats(void)
 {
-  return Z_CallocTag(n, n2, ZONE_LEVEL);
+  int i, file_count;
+  FILE *file;
+  zone_site_t **sorted;
+  zone_file_t *files;
+
+  file = M_OpenFile(zone_site_stats_filename, "w");
+
+  if (!file)
+  {
+    lprintf(LO_WARN, "Z_WriteSiteStats: unable to open %s\n", zone_site_stats_filename);
+    return;
+  }
+
+  sorted = Z_SortedSites(Z_CompareSitesByPeak);
+  files = Z_SortedFiles(&file_count);
+
+  fprintf(file, "live_bytes %lu\npeak_bytes %lu\n\n",
+          (unsigned long) zone_live_bytes, (unsigned long) zone_peak_bytes);
+
+  if (files)
+  {
+    fprintf(file, "%-32s %12s %12s %10s %10s\n",
+            "file", "live_bytes", "peak_bytes", "live_count", "allocs");
+
+    for (i = 0; i < file_count; ++i)
+      fprintf(file, "%-32s %12lu %12lu %10u %10u\n",
+              files[i].file,
+              (unsigned long) files[i].live_bytes,
+              (unsigned long) files[i].peak_bytes,
+              files[i].live_count,
+              files[i].allocations);
+
+    fprintf(file, "\n");
+  }
+
+  if (sorted)
+  {
+    fprintf(file, "%-40s %-6s %12s %12s %12s %10s %10s\n",
+            "site", "tag", "live_bytes", "peak_bytes", "total_bytes", "live_count", "allocs");
+
+    for (i = 0; i < zone_site_count; ++i)
+    {
+      char name[64];
+
+      snprintf(name, sizeof(name), "%s:%d", Z_SiteFileName(sorted[i]->file), sorted[i]->line);
+
+      fprintf(file, "%-40s %-6s %12lu %12lu %12lu %10u %10u\n",
+              name,
+              zone_tag_names[sorted[i]->tag],
+              (unsigned long) sorted[i]->live_bytes,
+              (unsigned long) sorted[i]->peak_bytes,
+              (unsigned long) sorted[i]->total_bytes,
+              sorted[i]->live_count,
+              sorted[i]->allocations);
+    }
+  }
+
+  free(sorted);
+  free(files);
+  fclose(file);
 }
 
-void *Z_ReallocLevel(void *p, size_t n)
+void Z_ResetSiteStats(void)
 {
-  return Z_ReallocTag(p, n, ZONE_LEVEL);
+  int i;
+
+  for (i = 0; i < zone_site_count; ++i)
+  {
+    zone_sites[i].peak_bytes = zone_sites[i].live_bytes;
+    zone_sites[i].total_bytes = 0;
+    zone_sites[i].allocations = 0;
+  }
+
+  zone_peak_bytes = zone_live_bytes;
 }
 
-char *Z_StrdupLevel(const char *s)
+void Z_EnableSiteStats(const char *filename)
 {
-  return Z_StrdupTag(s, ZONE_LEVEL);
+  if (zone_site_stats)
+    return;
+
+  zone_site_stats = true;
+
+  if (filename)
+  {
+    zone_site_stats_filename = filename;
+    I_AtExit(Z_WriteSiteStats, true, "Z_WriteSiteStats", exit_priority_normal);
+  }
 }
@@ -52,14 +52,41 @@
 void Z_Free(void *ptr);
 void Z_FreeLevel(void);
 
-void *Z_Malloc(size_t size);
-void *Z_Calloc(size_t n, size_t n2);
-void *Z_Realloc(void *p, size_t n);
-char *Z_Strdup(const char *s);
+// Allocations pass their call site so the zone statistics can attribute them
+void *(Z_Malloc)(size_t size, const char *file, int line);
+void *(Z_Calloc)(size_t n, size_t n2, const char *file, int line);
+void *(Z_Realloc)(void *p, size_t n, const char *file, int line);
+char *(Z_Strdup)(const char *s, const char *file, int line);
 
-void *Z_MallocLevel(size_t size);
-void *Z_CallocLevel(size_t n, size_t n2);
-void *Z_ReallocLevel(void *p, size_t n);
-char *Z_StrdupLevel(const char *s);
+void *(Z_MallocLevel)(size_t size, const char *file, int line);
+void *(Z_CallocLevel)(size_t n, size_t n2, const char *file, int line);
+void *(Z_ReallocLevel)(void *p, size_t n, const char *file, int line);
+char *(Z_StrdupLevel)(const char *s, const char *file, int line);
+
+#define Z_Malloc(a)          (Z_Malloc)(a, __FILE__, __LINE__)
+#define Z_Calloc(a, b)       (Z_Calloc)(a, b, __FILE__, __LINE__)
+#define Z_Realloc(a, b)      (Z_Realloc)(a, b, __FILE__, __LINE__)
+#define Z_Strdup(a)          (Z_Strdup)(a, __FILE__, __LINE__)
+
+#define Z_MallocLevel(a)     (Z_MallocLevel)(a, __FILE__, __LINE__)
+#define Z_CallocLevel(a, b)  (Z_CallocLevel)(a, b, __FILE__, __LINE__)
+#define Z_ReallocLevel(a, b) (Z_ReallocLevel)(a, b, __FILE__, __LINE__)
+#define Z_StrdupLevel(a)     (Z_StrdupLevel)(a, __FILE__, __LINE__)
+
+// Level arena - bump allocated, released all at once by Z_FreeLevel
+// These blocks must never be passed to Z_Free or Z_Realloc
+void *(Z_ArenaMalloc)(size_t size, const char *file, int line);
+void *(Z_ArenaCalloc)(size_t n, size_t n2, const char *file, int line);
+void *(Z_ArenaRealloc)(void *p, size_t old_size, size_t n, const char *file, int line);
+char *(Z_ArenaStrdup)(const char *s, const char *file, int line);
+
+#define Z_ArenaMalloc(a)           (Z_ArenaMalloc)(a, __FILE__, __LINE__)
+#define Z_ArenaCalloc(a, b)        (Z_ArenaCalloc)(a, b, __FILE__, __LINE__)
+#define Z_ArenaRealloc(a, b, c)    (Z_ArenaRealloc)(a, b, c, __FILE__, __LINE__)
+#define Z_ArenaStrdup(a)           (Z_ArenaStrdup)(a, __FILE__, __LINE__)
+
+void Z_EnableSiteStats(const char *filename);
+void Z_PrintSiteStats(int limit);
+void Z_ResetSiteStats(void);
 
 #endif